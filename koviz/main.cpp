@@ -12,6 +12,7 @@ using namespace std;
 #include <QDir>
 #include <QFileInfo>
 #include <QTextStream>
+#include <QThread>
 #include <stdio.h>
 #include <float.h>
 
@@ -42,6 +43,8 @@ bool writeCsv(const QString& fcsv, const QStringList& timeNames,
 bool convert2csv(const QStringList& timeNames,
                  const QString& ftrk, const QString& fcsv);
 bool convert2trk(const QString& csvFileName, const QString &trkFileName);
+void benchPdf(PlotMainWindow& w, const QString& pdfOutFile);
+void benchBookModel(PlotBookModel* bookModel);
 QHash<QString,QVariant> getShiftHash(const QString& shiftString,
                                 const QStringList &runDirs);
 QHash<QString,QStringList> getVarMap(const QString& mapString);
@@ -157,6 +160,9 @@ class SnapOptions : public Options
     QString buttonZoom;
     QString buttonReset;
     QString platform;
+    bool isColumnCache;
+    uint columnCacheMB;
+    bool isBench;
 };
 
 SnapOptions opts;
@@ -176,7 +182,8 @@ int main(int argc, char *argv[])
     opts.add("-start", &opts.start, -DBL_MAX, "start time", preset_start);
     opts.add("-stop", &opts.stop, DBL_MAX, "stop time", preset_stop);
     opts.add("-pres",&opts.presentation,"",
-             "present plot with two curves as compare,error or error+compare",
+             "present plot with two curves as compare,error or error+compare "
+             "(or many curves as statistics)",
              presetPresentation);
     opts.add("-beginRun",&opts.beginRun,0,
              "begin run (inclusive) in set of Monte carlo RUNs",
@@ -299,6 +306,13 @@ int main(int argc, char *argv[])
              &opts.buttonReset,"right","left, middle or right mouse button");
     opts.add("-platform",
              &opts.platform,"","Set to \"offscreen\" for pdf without X");
+    opts.add("-columnCache:{0,1}",&opts.isColumnCache,true,
+             "Copy plotted trk columns into memory for faster redraws");
+    opts.add("-columnCacheMB", &opts.columnCacheMB, 256,
+             "Memory limit (MB) of the trk column cache");
+    opts.add("-bench:{0,1}",&opts.isBench,false,
+             "Print timings of book model lookups and of -pdf "
+             "(serial vs threaded)");
 
     opts.parse(argc,argv, QString("koviz"), &ok);
 
@@ -317,6 +331,9 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    TrickModel::setColumnCacheEnabled(opts.isColumnCache);
+    TrickModel::setColumnCacheMaxBytes((qint64)opts.columnCacheMB*1024LL*1024LL);
+
     QStringList dps;
     QStringList runDirs;
     foreach ( QString f, opts.rundps ) {
@@ -1254,7 +1271,20 @@ int main(int argc, char *argv[])
                              varsModel,
                              monteInputsModel);
 
-            if ( isPdf ) {
+            if ( isPdf || opts.isBench ) {
+                // Curves (e.g. from -a) are added as they are built by the
+                // event loop, which does not run for -pdf
+                w.waitForCurves();
+            }
+
+            if ( opts.isBench ) {
+                benchBookModel(bookModel);
+            }
+
+            if ( isPdf && opts.isBench ) {
+                benchPdf(w,pdfOutFile);
+                ret = 0;
+            } else if ( isPdf ) {
                 w.savePdf(pdfOutFile);
                 ret = 0;
             } else {
@@ -1360,9 +1390,10 @@ void presetPresentation(QString* presVar, const QString& pres, bool* ok)
     Q_UNUSED(presVar);
 
     if ( !pres.isEmpty() && pres != "compare" && pres != "error" &&
-         pres != "error+compare" ) {
+         pres != "error+compare" && pres != "statistics" ) {
         fprintf(stderr,"koviz [error] : option -presentation, set to \"%s\", "
-                "should be \"compare\", \"error\" or \"error+compare\"\n",
+                "should be \"compare\", \"error\", \"error+compare\" "
+                "or \"statistics\"\n",
                 pres.toLatin1().constData());
         *ok = false;
     }
@@ -2527,3 +2558,96 @@ QStringList runsSubset(const QStringList& runsList,
 
     return subset;
 }
+
+// Times saving the pdf on one thread, then on a thread per core
+void benchPdf(PlotMainWindow& w, const QString& pdfOutFile)
+{
+#ifdef __linux
+    TimeItLinux timer;
+
+    w.setPrintThreadCount(1);
+    timer.start();
+    w.savePdf(pdfOutFile);
+    long serialUs = timer.stop();
+
+    w.setPrintThreadCount(0);
+    timer.start();
+    w.savePdf(pdfOutFile);
+    long threadedUs = timer.stop();
+
+    fprintf(stderr,"koviz [bench]: savePdf serial=%.1fms "
+                   "threaded(%d threads)=%.1fms speedup=%.2fx\n",
+                   serialUs/1000.0,
+                   qMax(QThread::idealThreadCount(),1),
+                   threadedUs/1000.0,
+                   threadedUs > 0 ? (double)serialUs/threadedUs : 0.0);
+#else
+    fprintf(stderr,"koviz [todo]: -bench is only supported on linux\n");
+    w.savePdf(pdfOutFile);
+#endif
+}
+
+// Times getDataString() on every plot and curve tag in the book,
+// as done when painting and printing
+void benchBookModel(PlotBookModel* bookModel)
+{
+#ifdef __linux
+    QList<QModelIndex> parentIdxs;
+    QList<QString> parentTags;
+    foreach ( QModelIndex pageIdx, bookModel->pageIdxs() ) {
+        foreach ( QModelIndex plotIdx, bookModel->plotIdxs(pageIdx) ) {
+            parentIdxs << plotIdx;
+            parentTags << "Plot";
+            QModelIndex curvesIdx = bookModel->getIndex(plotIdx,
+                                                        "Curves","Plot");
+            foreach ( QModelIndex curveIdx,
+                      bookModel->curveIdxs(curvesIdx) ) {
+                parentIdxs << curveIdx;
+                parentTags << "Curve";
+            }
+        }
+    }
+
+    QList<QStringList> childTags;
+    int nLookups = 0;
+    for ( int i = 0; i < parentIdxs.size(); ++i ) {
+        QStringList tags;
+        int rc = bookModel->rowCount(parentIdxs.at(i));
+        for ( int j = 0; j < rc; ++j ) {
+            QModelIndex tagIdx = bookModel->index(j,0,parentIdxs.at(i));
+            QString tag = bookModel->data(tagIdx).toString();
+            if ( tag != "Curves" && tag != "CurveData" ) {
+                tags << tag;
+            }
+        }
+        childTags << tags;
+        nLookups += tags.size();
+    }
+    if ( nLookups == 0 ) {
+        fprintf(stderr,"koviz [bench]: getDataString no plots in book\n");
+        return;
+    }
+
+    const int nReps = 100;
+    TimeItLinux timer;
+    timer.start();
+    int nChars = 0;
+    for ( int k = 0; k < nReps; ++k ) {
+        for ( int i = 0; i < parentIdxs.size(); ++i ) {
+            foreach ( QString tag, childTags.at(i) ) {
+                nChars += bookModel->getDataString(parentIdxs.at(i),tag,
+                                                   parentTags.at(i)).size();
+            }
+        }
+    }
+    long us = timer.stop();
+
+    fprintf(stderr,"koviz [bench]: getDataString %d lookups=%.1fms "
+                   "(%.1fns/lookup, %d chars)\n",
+                   nReps*nLookups, us/1000.0,
+                   1000.0*us/((double)nReps*nLookups), nChars);
+#else
+    Q_UNUSED(bookModel);
+    fprintf(stderr,"koviz [todo]: -bench is only supported on linux\n");
+#endif
+}
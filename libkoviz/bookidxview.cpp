@@ -505,9 +505,8 @@ void BookIdxView::_paintCurvesLegend(const QRect& R,
         return;
     }
 
-    QString pres = _bookModel()->getDataString(curvesIdx.parent(),
-                                               "PlotPresentation","Plot");
-    if ( pres == "error" ) {
+    QString pres = _bookModel()->plotPresentation(curvesIdx.parent());
+    if ( pres == "error" || pres == "statistics" ) {
         return;
     }
 
@@ -660,132 +659,7 @@ void BookIdxView::__paintCurvesLegend(const QRect& R,
 void BookIdxView::__paintSymbol(const QPointF& p,
                                const QString &symbol, QPainter &painter)
 {
-
-    QPen origPen = painter.pen();
-    QPen pen = painter.pen();
-    pen.setStyle(Qt::SolidLine);
-    painter.setPen(pen);
-
-    if ( symbol == "circle" ) {
-        painter.drawEllipse(p,2,2);
-    } else if ( symbol == "thick_circle" ) {
-        pen.setWidth(2.0);
-        painter.setPen(pen);
-        painter.drawEllipse(p,3,3);
-    } else if ( symbol == "solid_circle" ) {
-        pen.setWidthF(2.0);
-        painter.setPen(pen);
-        painter.drawEllipse(p,1,1);
-    } else if ( symbol == "square" ) {
-        double x = p.x()-2.0;
-        double y = p.y()-2.0;
-        painter.drawRect(QRectF(x,y,4,4));
-    } else if ( symbol == "thick_square") {
-        pen.setWidthF(2.0);
-        painter.setPen(pen);
-        double x = p.x()-3.0;
-        double y = p.y()-3.0;
-        painter.drawRect(QRectF(x,y,6,6));
-    } else if ( symbol == "solid_square" ) {
-        pen.setWidthF(4.0);
-        painter.setPen(pen);
-        painter.drawPoint(p); // happens to be a solid square
-    } else if ( symbol == "star" ) { // *
-        double r = 3.0;
-        QPointF a(p.x()+r*cos(18.0*M_PI/180.0),
-                  p.y()-r*sin(18.0*M_PI/180.0));
-        QPointF b(p.x(),p.y()-r);
-        QPointF c(p.x()-r*cos(18.0*M_PI/180.0),
-                  p.y()-r*sin(18.0*M_PI/180.0));
-        QPointF d(p.x()-r*cos(54.0*M_PI/180.0),
-                  p.y()+r*sin(54.0*M_PI/180.0));
-        QPointF e(p.x()+r*cos(54.0*M_PI/180.0),
-                  p.y()+r*sin(54.0*M_PI/180.0));
-        painter.drawLine(p,a);
-        painter.drawLine(p,b);
-        painter.drawLine(p,c);
-        painter.drawLine(p,d);
-        painter.drawLine(p,e);
-    } else if ( symbol == "xx" ) {
-        pen.setWidthF(2.0);
-        painter.setPen(pen);
-        QPointF a(p.x()+2.0,p.y()+2.0);
-        QPointF b(p.x()-2.0,p.y()+2.0);
-        QPointF c(p.x()-2.0,p.y()-2.0);
-        QPointF d(p.x()+2.0,p.y()-2.0);
-        painter.drawLine(p,a);
-        painter.drawLine(p,b);
-        painter.drawLine(p,c);
-        painter.drawLine(p,d);
-    } else if ( symbol == "triangle" ) {
-        double r = 3.0;
-        QPointF a(p.x(),p.y()-r);
-        QPointF b(p.x()-r*cos(30.0*M_PI/180.0),
-                  p.y()+r*sin(30.0*M_PI/180.0));
-        QPointF c(p.x()+r*cos(30.0*M_PI/180.0),
-                  p.y()+r*sin(30.0*M_PI/180.0));
-        painter.drawLine(a,b);
-        painter.drawLine(b,c);
-        painter.drawLine(c,a);
-    } else if ( symbol == "thick_triangle" ) {
-        pen.setWidthF(2.0);
-        painter.setPen(pen);
-        double r = 4.0;
-        QPointF a(p.x(),p.y()-r);
-        QPointF b(p.x()-r*cos(30.0*M_PI/180.0),
-                  p.y()+r*sin(30.0*M_PI/180.0));
-        QPointF c(p.x()+r*cos(30.0*M_PI/180.0),
-                  p.y()+r*sin(30.0*M_PI/180.0));
-        painter.drawLine(a,b);
-        painter.drawLine(b,c);
-        painter.drawLine(c,a);
-    } else if ( symbol == "solid_triangle" ) {
-        pen.setWidthF(2.0);
-        painter.setPen(pen);
-        double r = 3.0;
-        QPointF a(p.x(),p.y()-r);
-        QPointF b(p.x()-r*cos(30.0*M_PI/180.0),
-                  p.y()+r*sin(30.0*M_PI/180.0));
-        QPointF c(p.x()+r*cos(30.0*M_PI/180.0),
-                  p.y()+r*sin(30.0*M_PI/180.0));
-        painter.drawLine(a,b);
-        painter.drawLine(b,c);
-        painter.drawLine(c,a);
-    } else if ( symbol.startsWith("number_",Qt::CaseInsensitive) &&
-                symbol.size() == 8 ) {
-
-        QFont origFont = painter.font();
-        QBrush origBrush = painter.brush();
-
-        // Calculate bbox to draw text in
-        QString number = symbol.right(1); // last char is '0'-'9'
-        QFont font = painter.font();
-        font.setPointSize(7);
-        painter.setFont(font);
-        QFontMetrics fm = painter.fontMetrics();
-        QRectF bbox(fm.tightBoundingRect(number));
-        bbox.moveCenter(p);
-
-        // Draw solid circle around number
-        QRectF box(bbox);
-        double l = 3.0*qMax(box.width(),box.height())/2.0;
-        box.setWidth(l);
-        box.setHeight(l);
-        box.moveCenter(p);
-        QBrush brush(pen.color());
-        painter.setBrush(brush);
-        painter.drawEllipse(box);
-
-        // Draw number in white in middle of circle
-        QPen whitePen("white");
-        painter.setPen(whitePen);
-        painter.drawText(bbox,Qt::AlignCenter,number);
-
-        painter.setFont(origFont);
-        painter.setBrush(origBrush);
-    }
-
-    painter.setPen(origPen);
+    CurvesRenderer::paintSymbol(p,symbol,painter);
 }
 
 void BookIdxView::_paintGrid(QPainter &painter, const QModelIndex& plotIdx)
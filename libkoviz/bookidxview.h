@@ -11,6 +11,7 @@
 #include <cmath>
 #include "bookmodel.h"
 #include "unit.h"
+#include "curvesrenderer.h"
 
 struct LabelBox
 {
@@ -1,7 +1,30 @@
 #include "bookmodel.h"
 #include <float.h>
+#include <qnumeric.h>
 #include "unit.h"
 
+// Root items are added in this order (see koviz main.cpp)
+static QHash<QString,int> _createRootTagRows()
+{
+    QStringList tags;
+    tags << "Pages" << "Tables" << "DefaultPageTitles" << "LiveCoordTime"
+         << "LiveCoordTimeIndex" << "StartTime" << "StopTime"
+         << "Presentation" << "IsShowLiveCoord" << "RunToShiftHash"
+         << "LegendLabels" << "Orientation" << "TimeMatchTolerance"
+         << "Frequency" << "IsLegend" << "LegendColors"
+         << "ForegroundColor" << "BackgroundColor" << "Linestyles"
+         << "Symbolstyles" << "Groups" << "StatusBarMessage"
+         << "IsShowPageTitle" << "IsShowPlotLegend" << "PlotLegendPosition"
+         << "ButtonSelectAndPan" << "ButtonZoom" << "ButtonReset";
+
+    QHash<QString,int> rows;
+    for ( int i = 0; i < tags.size(); ++i ) {
+        rows.insert(tags.at(i),i);
+    }
+    return rows;
+}
+static const QHash<QString,int> _rootTagRows = _createRootTagRows();
+
 PlotBookModel::PlotBookModel(const QStringList& timeNames,
                              Runs *runs, QObject *parent) :
     QStandardItemModel(parent),
@@ -30,6 +53,36 @@ PlotBookModel::~PlotBookModel()
     }
     _curve2path.clear();
 
+    foreach ( CurveLod* lod, _curve2lod.values() ) {
+        delete lod;
+    }
+    _curve2lod.clear();
+
+    foreach ( CurveHitIndex* hitIndex, _curve2hitIndex.values() ) {
+        delete hitIndex;
+    }
+    _curve2hitIndex.clear();
+
+    foreach ( CurveTimeIndex* timeIndex, _curve2timeIndex.values() ) {
+        CurveTimeIndex::release(timeIndex);
+    }
+    _curve2timeIndex.clear();
+
+    foreach ( CurvesErrorCache* cache, _curves2errorCache.values() ) {
+        delete cache;
+    }
+    _curves2errorCache.clear();
+
+    foreach ( CurvesStatsCache* cache, _curves2statsCache.values() ) {
+        delete cache;
+    }
+    _curves2statsCache.clear();
+
+    foreach ( CurvePathBuild* build, _curve2pathBuild.values() ) {
+        delete build;
+    }
+    _curve2pathBuild.clear();
+
     foreach ( QModelIndex pageIdx, pageIdxs() ) {
         foreach ( QModelIndex plotIdx, plotIdxs(pageIdx) ) {
             QModelIndex curvesIdx = getIndex(plotIdx,"Curves","Plot");
@@ -45,11 +98,18 @@ bool PlotBookModel::setData(const QModelIndex &idx,
                             const QVariant &value, int role)
 {
     // If setting curve data, for speed, cache a painterpath out of curve model
+    QModelIndex presentationPlotIdx;
+    bool isStatistics = false;
     if ( idx.column() == 1 ) {
         QModelIndex tagIdx = sibling(idx.row(),0,idx);
         QString tag = data(tagIdx).toString();
         if ( tag == "CurveData" ) {
             CurveModel* curveModel = QVariantToPtr<CurveModel>::convert(value);
+            CurveModel* oldCurveModel =
+                             QVariantToPtr<CurveModel>::convert(data(idx));
+            if ( oldCurveModel && oldCurveModel != curveModel ) {
+                _removeCurveCaches(oldCurveModel);
+            }
             QModelIndex curveIdx = idx.parent();
             _createPainterPath(curveIdx,
                                false,0,false,0,false,0,
@@ -138,10 +198,67 @@ bool PlotBookModel::setData(const QModelIndex &idx,
                                        "",yUnit,plotXScale,plotYScale);
                 }
             }
+        } else if ( tag == "PlotPresentation" ) {
+            // Curves of statistics plots have no paths (see below)
+            presentationPlotIdx = idx.parent();
+            if ( isIndex(presentationPlotIdx,"Plot") ) {
+                isStatistics = (plotPresentation(presentationPlotIdx) ==
+                                "statistics");
+            } else {
+                presentationPlotIdx = QModelIndex();
+            }
         }
     }
 
-    return QStandardItemModel::setData(idx,value,role);
+    // A curve's props are refilled from its children on the next read.
+    // Marked before and after so that a read in between is redone.
+    _setCurvePropsDirty(idx);
+    bool ret = QStandardItemModel::setData(idx,value,role);
+    _setCurvePropsDirty(idx);
+
+    // Tag changed, so rehash its siblings' tags
+    if ( idx.column() == 0 ) {
+        _clearTagRows();
+    }
+
+    // Build (or drop) curve paths when a plot toggles to/from statistics
+    if ( presentationPlotIdx.isValid() &&
+         isStatistics != (plotPresentation(presentationPlotIdx) ==
+                          "statistics") &&
+         isChildIndex(presentationPlotIdx,"Plot","Curves") ) {
+        QModelIndex curvesIdx = getIndex(presentationPlotIdx,"Curves","Plot");
+        foreach ( QModelIndex curveIdx, curveIdxs(curvesIdx) ) {
+            if ( getCurveModel(curveIdx) ) {
+                _createPainterPath(curveIdx,
+                                   false,0,false,0,false,0,
+                                   false,0,false,0,false,0);
+            }
+        }
+    }
+
+    return ret;
+}
+
+void PlotBookModel::_setCurvePropsDirty(const QModelIndex &idx)
+{
+    QStandardItem* parentItem = itemFromIndex(idx.parent());
+    if ( parentItem && parentItem->type() == CurveItem::Type ) {
+        QMutexLocker locker(&_curvePropsMutex);
+        static_cast<CurveItem*>(parentItem)->setDirty();
+    }
+}
+
+// Curve item's children as a record (see CurveProps)
+CurveProps PlotBookModel::curveProps(const QModelIndex &curveIdx) const
+{
+    QStandardItem* item = itemFromIndex(curveIdx);
+    if ( !item || item->type() != CurveItem::Type ) {
+        fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::curveProps() : "
+                       "expected a \"Curve\" index.\n");
+        exit(-1);
+    }
+    QMutexLocker locker(&_curvePropsMutex);
+    return static_cast<CurveItem*>(item)->props();
 }
 
 void PlotBookModel::setPlotMathRect(const QRectF& mathRect,
@@ -162,7 +279,12 @@ QStandardItem *PlotBookModel::addChild(QStandardItem *parentItem,
                                        const QString &childTitle,
                                        const QVariant &childValue)
 {
-    QStandardItem *columnZeroItem = new QStandardItem(childTitle);
+    QStandardItem *columnZeroItem;
+    if ( childTitle == "Curve" ) {
+        columnZeroItem = new CurveItem(childTitle);
+    } else {
+        columnZeroItem = new QStandardItem(childTitle);
+    }
     QStandardItem *columnOneItem = new QStandardItem(childValue.toString());
 
     QList<QStandardItem*> items;
@@ -364,6 +486,48 @@ QColor PlotBookModel::flatLineColor() const
     return green;
 }
 
+QColor PlotBookModel::statsBandColor(CurveStats::Band band) const
+{
+    QColor color;
+    switch ( band ) {
+    case CurveStats::BandMin:
+    case CurveStats::BandMax:
+        color = QColor(128,128,128);  // gray
+        break;
+    case CurveStats::BandP5:
+    case CurveStats::BandP95:
+    case CurveStats::BandP50:
+        color = QColor(40,80,170);    // blue
+        break;
+    default:
+        color = QColor(190,30,30);    // red for mean and mean+/-sigma
+        break;
+    }
+    return color;
+}
+
+QString PlotBookModel::statsBandLineStyle(CurveStats::Band band) const
+{
+    QString style;
+    switch ( band ) {
+    case CurveStats::BandMin:
+    case CurveStats::BandMax:
+        style = "fine_dash";
+        break;
+    case CurveStats::BandP50:
+        style = "thick_line";
+        break;
+    case CurveStats::BandMeanMinusSigma:
+    case CurveStats::BandMeanPlusSigma:
+        style = "dash";
+        break;
+    default:
+        style = "plain";
+        break;
+    }
+    return style;
+}
+
 QRectF PlotBookModel::getPlotMathRect(const QModelIndex &plotIdx) const
 {
     QRectF M;
@@ -451,84 +615,18 @@ QModelIndex PlotBookModel::getIndex(const QModelIndex &startIdx,
     }
 
     if ( !startIdx.isValid() ) {
-        if ( searchItemText == "Pages" ) {
-            idx = index(0,0);
-        } else if ( searchItemText == "Tables" ) {
-            idx = index(1,0);
-        } else if ( searchItemText == "DefaultPageTitles" ) {
-            idx = index(2,0);
-        } else if ( searchItemText == "LiveCoordTime" ) {
-            idx = index(3,0);
-        } else if ( searchItemText == "LiveCoordTimeIndex" ) {
-            idx = index(4,0);
-        } else if ( searchItemText == "StartTime" ) {
-            idx = index(5,0);
-        } else if ( searchItemText == "StopTime" ) {
-            idx = index(6,0);
-        } else if ( searchItemText == "Presentation" ) {
-            idx = index(7,0);
-        } else if ( searchItemText == "IsShowLiveCoord" ) {
-            idx = index(8,0);
-        } else if ( searchItemText == "RunToShiftHash" ) {
-            idx = index(9,0);
-        } else if ( searchItemText == "LegendLabels" ) {
-            idx = index(10,0);
-        } else if ( searchItemText == "Orientation" ) {
-            idx = index(11,0);
-        } else if ( searchItemText == "TimeMatchTolerance" ) {
-            idx = index(12,0);
-        } else if ( searchItemText == "Frequency" ) {
-            idx = index(13,0);
-        } else if ( searchItemText == "IsLegend" ) {
-            idx = index(14,0);
-        } else if ( searchItemText == "LegendColors" ) {
-            idx = index(15,0);
-        } else if ( searchItemText == "ForegroundColor" ) {
-            idx = index(16,0);
-        } else if ( searchItemText == "BackgroundColor" ) {
-            idx = index(17,0);
-        } else if ( searchItemText == "Linestyles" ) {
-            idx = index(18,0);
-        } else if ( searchItemText == "Symbolstyles" ) {
-            idx = index(19,0);
-        } else if ( searchItemText == "Groups" ) {
-            idx = index(20,0);
-        } else if ( searchItemText == "StatusBarMessage" ) {
-            idx = index(21,0);
-        } else if ( searchItemText == "IsShowPageTitle" ) {
-            idx = index(22,0);
-        } else if ( searchItemText == "IsShowPlotLegend" ) {
-            idx = index(23,0);
-        } else if ( searchItemText == "PlotLegendPosition" ) {
-            idx = index(24,0);
-        } else if ( searchItemText == "ButtonSelectAndPan" ) {
-            idx = index(25,0);
-        } else if ( searchItemText == "ButtonZoom" ) {
-            idx = index(26,0);
-        } else if ( searchItemText == "ButtonReset" ) {
-            idx = index(27,0);
-        } else {
+        int row = _rootTagRows.value(searchItemText,-1);
+        if ( row < 0 ) {
             fprintf(stderr,"koviz [bad scoobs]:3: getIndex() received "
                            "root as a startIdx and had bad child "
                            "item text of \"%s\".\n",
                            searchItemText.toLatin1().constData());
             exit(-1);
         }
+        idx = index(row,0);
     } else {
-        QStringList cStrings;
-        int rc = itemFromIndex(startIdx)->rowCount();
-        bool isFound = false;
-        for ( int i = 0; i < rc; ++i ) {
-            QModelIndex cIdx = index(i,0,startIdx);
-            QString cText = itemFromIndex(cIdx)->text();
-            cStrings << cText;
-            if ( cText == searchItemText ) {
-                idx = cIdx;
-                isFound = true;
-                break;
-            }
-        }
-        if ( !isFound ) {
+        int row = _childRow(startIdx,searchItemText);
+        if ( row < 0 ) {
             fprintf(stderr,
                     "koviz [bad scoobs]:4:PlotBookModel::getIndex()\n"
                     "startIdxText=%s\n"
@@ -541,11 +639,137 @@ QModelIndex PlotBookModel::getIndex(const QModelIndex &startIdx,
                     rowCount(startIdx));
             exit(-1);
         }
+        idx = index(row,0,startIdx);
     }
 
     return idx;
 }
 
+// Row of the first child of pidx with tag (-1 if none)
+//
+// Tags are hashed per parent item.  A hash is checked against the tree on
+// lookup (row count and the tag at the row) and rehashed if stale, so it
+// needs no upkeep when rows are appended with the model's signals blocked.
+// Removing rows clears all hashes since removed items are freed.
+int PlotBookModel::_childRow(const QModelIndex &pidx, const QString &tag) const
+{
+    QStandardItem* pItem = itemFromIndex(pidx);
+    if ( !pItem ) {
+        return -1;
+    }
+    int rc = pItem->rowCount();
+
+    _tagRowsLock.lockForRead();
+    QHash<const QStandardItem*,BookTagRows>::const_iterator it =
+                                                _item2tagRows.constFind(pItem);
+    if ( it != _item2tagRows.constEnd() && it.value().rowCount == rc ) {
+        int row = it.value().rows.value(tag,-1);
+        if ( row < 0 ) {
+            _tagRowsLock.unlock();
+            return -1;
+        }
+        QStandardItem* cItem = pItem->child(row,0);
+        if ( cItem && cItem->text() == tag ) {
+            _tagRowsLock.unlock();
+            return row;
+        }
+    }
+    _tagRowsLock.unlock();
+
+    // Rehash (last insert of a repeated tag is its first row)
+    BookTagRows tagRows;
+    tagRows.rowCount = rc;
+    for ( int i = rc-1; i >= 0; --i ) {
+        QStandardItem* cItem = pItem->child(i,0);
+        if ( cItem ) {
+            tagRows.rows.insert(cItem->text(),i);
+        }
+    }
+    int row = tagRows.rows.value(tag,-1);
+
+    QWriteLocker locker(&_tagRowsLock);
+    _item2tagRows.insert(pItem,tagRows);
+
+    return row;
+}
+
+void PlotBookModel::_clearTagRows()
+{
+    QWriteLocker locker(&_tagRowsLock);
+    _item2tagRows.clear();
+}
+
+bool PlotBookModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    // Drop what's cached for curves under the rows, so that an entry
+    // isn't found again for a new curve given a removed curve's address
+    QList<CurveModel*> curveModels;
+    for ( int i = row; i < row+count && i < rowCount(parent); ++i ) {
+        _curveModels(index(i,0,parent),&curveModels);
+    }
+    foreach ( CurveModel* curveModel, curveModels ) {
+        _removeCurveCaches(curveModel);
+    }
+
+    // Cleared after too, since rowsAboutToBeRemoved slots may look up
+    // children of the items being removed
+    _clearTagRows();
+    bool ret = QStandardItemModel::removeRows(row,count,parent);
+    _clearTagRows();
+    return ret;
+}
+
+// Appends the curve models of the CurveData items at or under idx
+void PlotBookModel::_curveModels(const QModelIndex &idx,
+                                 QList<CurveModel*> *curveModels) const
+{
+    if ( data(idx).toString() == "CurveData" ) {
+        QModelIndex dataIdx = sibling(idx.row(),1,idx);
+        CurveModel* curveModel =
+                           QVariantToPtr<CurveModel>::convert(data(dataIdx));
+        if ( curveModel ) {
+            curveModels->append(curveModel);
+        }
+    }
+    int rc = rowCount(idx);
+    for ( int i = 0; i < rc; ++i ) {
+        _curveModels(index(i,0,idx),curveModels);
+    }
+}
+
+// Deletes the paths, indices and error/stats caches of curveModel
+void PlotBookModel::_removeCurveCaches(CurveModel *curveModel)
+{
+    delete _curve2path.take(curveModel);
+    delete _curve2lod.take(curveModel);
+    delete _curve2hitIndex.take(curveModel);
+    CurveTimeIndex::release(_curve2timeIndex.take(curveModel));
+    delete _curve2pathBuild.take(curveModel);
+
+    QHash<QPair<CurveModel*,CurveModel*>,CurvesErrorCache*>::iterator e =
+                                                  _curves2errorCache.begin();
+    while ( e != _curves2errorCache.end() ) {
+        if ( e.key().first == curveModel || e.key().second == curveModel ) {
+            delete e.value();
+            e = _curves2errorCache.erase(e);
+        } else {
+            ++e;
+        }
+    }
+
+    QMutexLocker locker(&_curves2statsCacheMutex);
+    QHash<CurveModel*,CurvesStatsCache*>::iterator s =
+                                                  _curves2statsCache.begin();
+    while ( s != _curves2statsCache.end() ) {
+        if ( s.key() == curveModel || s.value()->curves.contains(curveModel) ) {
+            delete s.value();
+            s = _curves2statsCache.erase(s);
+        } else {
+            ++s;
+        }
+    }
+}
+
 QModelIndex PlotBookModel::getDataIndex(const QModelIndex &startIdx,
                                     const QString &searchItemText,
                                     const QString &expectedStartIdxText) const
@@ -711,17 +935,15 @@ CurveModel *PlotBookModel::getCurveModel(const QModelIndex& curvesIdx,
 
 CurveModel *PlotBookModel::getCurveModel(const QModelIndex &curveIdx) const
 {
-    if ( !isIndex(curveIdx, "Curve") ) {
+    QStandardItem* item = itemFromIndex(curveIdx);
+    if ( !item || item->type() != CurveItem::Type ) {
         fprintf(stderr,"koviz [bad scoobs]:2: "
                        "PlotBookModel::getCurveModel()\n");
         exit(-1);
     }
 
-    QModelIndex curveDataIdx = getDataIndex(curveIdx,"CurveData");
-    QVariant v = data(curveDataIdx);
-    CurveModel* curveModel =QVariantToPtr<CurveModel>::convert(v);
-
-    return curveModel;
+    QMutexLocker locker(&_curvePropsMutex);
+    return static_cast<CurveItem*>(item)->props().curveModel;
 }
 
 QPainterPath* PlotBookModel::getPainterPath(const QModelIndex &curveIdx) const
@@ -741,12 +963,56 @@ QPainterPath* PlotBookModel::getPainterPath(const QModelIndex &curveIdx) const
     return path;
 }
 
-// TODO: cache error path if it's not changing
-QPainterPath *PlotBookModel::getCurvesErrorPath(const QModelIndex &curvesIdx)
+CurveLod* PlotBookModel::getCurveLod(const QModelIndex &curveIdx) const
 {
-    QPainterPath* path;
-    path = _createCurvesErrorPath(curvesIdx);
-    return path;
+    CurveLod* lod;
+
+    CurveModel* curveModel = getCurveModel(curveIdx);
+
+    if ( _curve2lod.contains(curveModel) ) {
+        lod = _curve2lod.value(curveModel);
+    } else {
+        fprintf(stderr,"koviz [bad scoobs]: "
+                       "PlotBookModel::getCurveLod()\n");
+        exit(-1);
+    }
+
+    return lod;
+}
+
+CurveHitIndex* PlotBookModel::getCurveHitIndex(const QModelIndex &curveIdx) const
+{
+    CurveHitIndex* hitIndex;
+
+    CurveModel* curveModel = getCurveModel(curveIdx);
+
+    if ( _curve2hitIndex.contains(curveModel) ) {
+        hitIndex = _curve2hitIndex.value(curveModel);
+    } else {
+        fprintf(stderr,"koviz [bad scoobs]: "
+                       "PlotBookModel::getCurveHitIndex()\n");
+        exit(-1);
+    }
+
+    return hitIndex;
+}
+
+CurveTimeIndex* PlotBookModel::getCurveTimeIndex(
+                                         const QModelIndex &curveIdx) const
+{
+    CurveTimeIndex* timeIndex;
+
+    CurveModel* curveModel = getCurveModel(curveIdx);
+
+    if ( _curve2timeIndex.contains(curveModel) ) {
+        timeIndex = _curve2timeIndex.value(curveModel);
+    } else {
+        fprintf(stderr,"koviz [bad scoobs]: "
+                       "PlotBookModel::getCurveTimeIndex()\n");
+        exit(-1);
+    }
+
+    return timeIndex;
 }
 
 QModelIndexList PlotBookModel::getIndexList(const QModelIndex &startIdx,
@@ -809,13 +1075,17 @@ bool PlotBookModel::isChildIndex(const QModelIndex &pidx,
 
     if (!isIndex(pidx,expectedParentItemText)) return false;
 
-    int rc = rowCount(pidx);
-    for ( int i = 0; i < rc; ++i ) {
-        QModelIndex cIdx = index(i,0,pidx);
-        QString cText = data(cIdx).toString();
-        if ( cText == childItemText ) {
-            isChild = true;
-            break;
+    if ( pidx.isValid() ) {
+        isChild = ( _childRow(pidx,childItemText) >= 0 );
+    } else {
+        int rc = rowCount(pidx);
+        for ( int i = 0; i < rc; ++i ) {
+            QModelIndex cIdx = index(i,0,pidx);
+            QString cText = data(cIdx).toString();
+            if ( cText == childItemText ) {
+                isChild = true;
+                break;
+            }
         }
     }
 
@@ -825,38 +1095,21 @@ bool PlotBookModel::isChildIndex(const QModelIndex &pidx,
 double PlotBookModel::xScale(const QModelIndex& curveIdx,
                              CurveModel *curveModelIn) const
 {
-    double xs = 1.0;
-
-    QString tag = data(curveIdx).toString();
-
-    if ( tag != "Curve" ) {
-        fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::xScale() : "
-                       "expected tag \"Curve\", instead tag=\"%s\".\n",
-                       tag.toLatin1().constData());
-        exit(-1);
-    }
-
-    CurveModel* curveModel = curveModelIn;
-    if ( !curveModel ) {
-        curveModel = getCurveModel(curveIdx);
-    }
-    if ( !curveModel ) {
-        xs = 0.0;
-        return xs;
+    CurveProps props = curveProps(curveIdx);
+    if ( !curveModelIn || curveModelIn == props.curveModel ) {
+        return props.xs;
     }
 
     // Unit scale
-    QModelIndex curveXUnitIdx = getDataIndex(curveIdx, "CurveXUnit","Curve");
-    QString bookXUnit = data(curveXUnitIdx).toString();
-    if ( !bookXUnit.isEmpty() && bookXUnit != "--" ) {
-        QString loggedXUnit = curveModel->x()->unit();
-        xs = Unit::scale(loggedXUnit,bookXUnit);
+    double xs = 1.0;
+    if ( !props.xUnit.isEmpty() && props.xUnit != "--" ) {
+        QString loggedXUnit = curveModelIn->x()->unit();
+        xs = Unit::scale(loggedXUnit,props.xUnit);
     }
 
     // Book model x scale
-    double k = getDataDouble(curveIdx,"CurveXScale","Curve");
-    if ( k != 1.0 ) {
-        xs *= k;
+    if ( props.xScale != 1.0 ) {
+        xs *= props.xScale;
     }
 
     return xs;
@@ -865,74 +1118,26 @@ double PlotBookModel::xScale(const QModelIndex& curveIdx,
 
 double PlotBookModel::yScale(const QModelIndex& curveIdx) const
 {
-    double ys = 1.0;
-
-    QString tag = data(curveIdx).toString();
-
-    if ( tag != "Curve" ) {
-        fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::yScale() : "
-                       "expected tag \"Curve\", instead tag=\"%s\".\n",
-                       tag.toLatin1().constData());
-        exit(-1);
-    }
-
-    CurveModel* curveModel = getCurveModel(curveIdx);
-    if ( !curveModel ) {
-        ys = 0.0;
-        return ys;
-    }
-
-    // Unit scale
-    QModelIndex curveYUnitIdx = getDataIndex(curveIdx, "CurveYUnit","Curve");
-    QString bookYUnit = data(curveYUnitIdx).toString();
-    if ( !bookYUnit.isEmpty() && bookYUnit != "--" ) {
-        QString loggedYUnit = curveModel->y()->unit();
-        ys = Unit::scale(loggedYUnit, bookYUnit);
-    }
-
-    // Book model y scale factor
-    double k = getDataDouble(curveIdx,"CurveYScale","Curve");
-    if ( k != 1.0 ) {
-        ys *= k;
-    }
-
-    return ys;
+    return curveProps(curveIdx).ys;
 }
 
 double PlotBookModel::xBias(const QModelIndex &curveIdx,
                             CurveModel *curveModelIn) const
 {
-    double xb = 0.0;
-
-    QString tag = data(curveIdx).toString();
-
-    if ( tag != "Curve" ) {
-        fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::xBias() : "
-                       "expected tag \"Curve\", instead tag=\"%s\".\n",
-                       tag.toLatin1().constData());
-        exit(-1);
-    }
-
-    CurveModel* curveModel = curveModelIn;
-    if ( !curveModel ) {
-        curveModel = getCurveModel(curveIdx);
-    }
-    if ( !curveModel ) {
-        xb = 0.0;
-        return xb;
+    CurveProps props = curveProps(curveIdx);
+    if ( !curveModelIn || curveModelIn == props.curveModel ) {
+        return props.xb;
     }
 
     // Unit bias (for temperature)
-    QModelIndex curveXUnitIdx = getDataIndex(curveIdx, "CurveXUnit","Curve");
-    QString bookXUnit = data(curveXUnitIdx).toString();
-    if ( !bookXUnit.isEmpty() && bookXUnit != "--" ) {
-        QString loggedXUnit = curveModel->x()->unit();
-        xb = Unit::bias(loggedXUnit, bookXUnit);
+    double xb = 0.0;
+    if ( !props.xUnit.isEmpty() && props.xUnit != "--" ) {
+        QString loggedXUnit = curveModelIn->x()->unit();
+        xb = Unit::bias(loggedXUnit, props.xUnit);
     }
 
-    double b = getDataDouble(curveIdx,"CurveXBias","Curve");
-    if ( b != 0.0 ) {
-        xb += b;
+    if ( props.xBias != 0.0 ) {
+        xb += props.xBias;
     }
 
     return xb;
@@ -940,37 +1145,7 @@ double PlotBookModel::xBias(const QModelIndex &curveIdx,
 
 double PlotBookModel::yBias(const QModelIndex &curveIdx) const
 {
-    double yb = 0.0;
-
-    QString tag = data(curveIdx).toString();
-
-    if ( tag != "Curve" ) {
-        fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::yBias() : "
-                       "expected tag \"Curve\", instead tag=\"%s\".\n",
-                       tag.toLatin1().constData());
-        exit(-1);
-    }
-
-    CurveModel* curveModel = getCurveModel(curveIdx);
-    if ( !curveModel ) {
-        yb = 0.0;
-        return yb;
-    }
-
-    // Unit bias (for temperature)
-    QModelIndex curveYUnitIdx = getDataIndex(curveIdx, "CurveYUnit","Curve");
-    QString bookYUnit = data(curveYUnitIdx).toString();
-    if ( !bookYUnit.isEmpty() && bookYUnit != "--" ) {
-        QString loggedYUnit = curveModel->y()->unit();
-        yb = Unit::bias(loggedYUnit, bookYUnit);
-    }
-
-    double b = getDataDouble(curveIdx,"CurveYBias","Curve");
-    if ( b != 0.0 ) {
-        yb += b;
-    }
-
-    return yb;
+    return curveProps(curveIdx).yb;
 }
 
 QRectF PlotBookModel::calcCurvesBBox(const QModelIndex &curvesIdx) const
@@ -980,25 +1155,26 @@ QRectF PlotBookModel::calcCurvesBBox(const QModelIndex &curvesIdx) const
     QModelIndex plotIdx = curvesIdx.parent();
     QString plotXScale = getDataString(plotIdx,"PlotXScale","Plot");
     QString plotYScale = getDataString(plotIdx,"PlotYScale","Plot");
-    QString presentation = getDataString(plotIdx,"PlotPresentation","Plot");
+    QString presentation = plotPresentation(plotIdx);
     if ( presentation == "compare" || presentation == "error+compare" ) {
         int rc = rowCount(curvesIdx);
         for (int i = 0; i < rc; ++i) {
             QModelIndex curveIdx = index(i,0,curvesIdx);
-            QPainterPath* path = getPainterPath(curveIdx);
+            CurveProps props = curveProps(curveIdx);
+            CurveLod* lod = getCurveLod(curveIdx);
             double xb = 0.0;
             double yb = 0.0;
             double xs = 1.0;
             double ys = 1.0;
             if ( plotXScale == "linear" ) {
-                xb = xBias(curveIdx);
-                xs = xScale(curveIdx);
+                xb = props.xb;
+                xs = props.xs;
             }
             if ( plotYScale == "linear" ) {
-                yb = yBias(curveIdx);
-                ys = yScale(curveIdx);
+                yb = props.yb;
+                ys = props.ys;
             }
-            QRectF pathBox = path->boundingRect();
+            QRectF pathBox = lod->boundingRect();
             double w = pathBox.width();
             double h = pathBox.height();
             QPointF topLeft(xs*pathBox.topLeft().x()+xb,
@@ -1007,14 +1183,12 @@ QRectF PlotBookModel::calcCurvesBBox(const QModelIndex &curvesIdx) const
             bbox = bbox.united(scaledPathBox);
         }
         if ( presentation == "error+compare" ) {
-            QPainterPath* errorPath = _createCurvesErrorPath(curvesIdx);
-            bbox = bbox.united(errorPath->boundingRect());
-            delete errorPath;
+            bbox = bbox.united(getCurvesErrorBBox(curvesIdx));
         }
     } else if ( presentation == "error" ) {
-        QPainterPath* errorPath = _createCurvesErrorPath(curvesIdx);
-        bbox = errorPath->boundingRect();
-        delete errorPath;
+        bbox = getCurvesErrorBBox(curvesIdx);
+    } else if ( presentation == "statistics" ) {
+        bbox = getCurvesStatsBBox(curvesIdx);
     } else {
         fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::calcCurvesBBox()\n");
         exit(-1);
@@ -1091,95 +1265,70 @@ QRectF PlotBookModel::calcCurvesBBox(const QModelIndex &curvesIdx) const
     return bbox;
 }
 
-// Note:
-//   No scaling or bias is done linear plot scale since it is done
-//   via the paint transform. For log scale, the path is scaled/biased.
-QPainterPath* PlotBookModel::__createPainterPath(CurveModel *curveModel,
-                                               double startTime,double stopTime,
-                                               double xs, double xb,
-                                               double ys, double yb,
-                                               const QString &plotXScale,
-                                               const QString &plotYScale)
+// Min/max y of the compared curves over the plot x window [x0,x1], used
+// to fit y to a zoomed window.  Returns false if the presentation has no
+// curve paths (error, statistics) or no curve has points in the window.
+bool PlotBookModel::calcCurvesYRange(const QModelIndex &curvesIdx,
+                                     double x0, double x1,
+                                     double *yMin, double *yMax) const
 {
-    QPainterPath* path = new QPainterPath;
-
-    curveModel->map();
-
-    ModelIterator* it = curveModel->begin();
-
-    bool isXLogScale = ( plotXScale == "log" ) ? true : false;
-    bool isYLogScale = ( plotYScale == "log" ) ? true : false;
+    QModelIndex plotIdx = curvesIdx.parent();
+    QString presentation = plotPresentation(plotIdx);
+    if ( presentation != "compare" ) {
+        return false;
+    }
+    QString plotXScale = getDataString(plotIdx,"PlotXScale","Plot");
+    QString plotYScale = getDataString(plotIdx,"PlotYScale","Plot");
 
-    double f = getDataDouble(QModelIndex(),"Frequency");
-    bool isFirst = true;
-    while ( !it->isDone() ) {
-        double t = it->t();
-        if ( f > 0.0 ) {
-            if ( fabs(t-round(t/f)*f) > 1.0e-9 ) { // t not divisible by f?
-                it->next();
-                continue;
-            }
-        }
-        if ( t < startTime || t > stopTime ) {
-            it->next();
+    bool isFound = false;
+    int rc = rowCount(curvesIdx);
+    for (int i = 0; i < rc; ++i) {
+        QModelIndex curveIdx = index(i,0,curvesIdx);
+        CurveProps props = curveProps(curveIdx);
+        CurveLod* lod = getCurveLod(curveIdx);
+        double xb = 0.0;
+        double yb = 0.0;
+        double xs = 1.0;
+        double ys = 1.0;
+        if ( plotXScale == "linear" ) {
+            xb = props.xb;
+            xs = props.xs;
+        }
+        if ( plotYScale == "linear" ) {
+            yb = props.yb;
+            ys = props.ys;
+        }
+        if ( xs == 0.0 ) {
             continue;
         }
 
-        double x = it->x();
-        double y = it->y();
-
-        if ( isXLogScale ) {
-            x = x*xs + xb;
-            if ( x > 0 ) {
-                x = log10(x);
-            } else if ( x < 0 ) {
-                x = log10(-x);
-            } else if ( x == 0 ) {
-                it->next();
-                continue; // skip log(0) since -inf
-            }
+        // Window in the path's (unscaled) x
+        double px0 = (x0-xb)/xs;
+        double px1 = (x1-xb)/xs;
+        if ( px0 > px1 ) {
+            qSwap(px0,px1);
         }
-
-        if ( isYLogScale ) {
-            y = y*ys + yb;
-            if ( y > 0 ) {
-                y = log10(y);
-            } else if ( y < 0 ) {
-                y = log10(-y);
-            } else if ( y == 0 ) {
-                it->next();
-                continue; // skip log(0) since -inf
-            }
+        double pyMin;
+        double pyMax;
+        if ( !lod->yRange(px0,px1,&pyMin,&pyMax) ) {
+            continue;
         }
-
-        if ( isFirst ) {
-            path->moveTo(x,y);
-            isFirst = false;
+        double y0 = ys*pyMin+yb;
+        double y1 = ys*pyMax+yb;
+        if ( y0 > y1 ) {
+            qSwap(y0,y1);
+        }
+        if ( !isFound ) {
+            *yMin = y0;
+            *yMax = y1;
+            isFound = true;
         } else {
-            int m = path->elementCount();
-            path->lineTo(x,y);
-            int n = path->elementCount();
-            if ( m == n ) {
-                /* When points are very close to one another,
-                 * it looks like Qt will skip adding a lineTo(x,y).
-                 * This bit of code tries to force Qt to add the
-                 * lineTo(x,y) no matter how close the two points
-                 * are to one another.
-                 */
-                path->lineTo(x+1.0,y+1.0);
-                int o = path->elementCount();
-                if ( o > m ) {
-                    path->setElementPositionAt(o-1,x,y);
-                }
-            }
+            *yMin = qMin(*yMin,y0);
+            *yMax = qMax(*yMax,y1);
         }
-
-        it->next();
     }
-    delete it;
-    curveModel->unmap();
 
-    return path;
+    return isFound;
 }
 
 void PlotBookModel::_createPainterPath(const QModelIndex &curveIdx,
@@ -1227,69 +1376,33 @@ void PlotBookModel::_createPainterPath(const QModelIndex &curveIdx,
         }
     }
 
-    // Get time shift (and scale)
-    double tb = 0.0;
-    double ts = 1.0;
-    if ( isXTime(plotIdx) ) {
-        tb = xBias(curveIdx,curveModel);
-        ts = xScale(curveIdx,curveModel);
-    }
-
-    // X Curve Scale/bias
-    double xs = 1.0;
-    double xb = 0.0;
+    // Curve units, scales and biases
     QString bookXUnit = xUnitIn;
     if ( bookXUnit.isEmpty() ) {
         QModelIndex curveXUnitIdx = getDataIndex(curveIdx,"CurveXUnit","Curve");
         bookXUnit = data(curveXUnitIdx).toString();
     }
-    if ( !bookXUnit.isEmpty() && bookXUnit != "--" ) {
-        QString loggedXUnit = curveModel->x()->unit();
-        xs = Unit::scale(loggedXUnit, bookXUnit);
-        xb = Unit::bias(loggedXUnit, bookXUnit);
-    }
     double j = xScaleIn;
     if ( !isUseXScaleIn ) {
         j = getDataDouble(curveIdx,"CurveXScale","Curve");
     }
-    if ( j != 1.0 ) {
-        xs *= j;
-    }
     double a = xBiasIn;
     if ( !isUseXBiasIn ) {
         a = getDataDouble(curveIdx,"CurveXBias","Curve");
     }
-    if ( a != 0.0 ) {
-        xb += a;
-    }
-
-    // Y Curve Scale/Bias
-    double ys = 1.0;
-    double yb = 0.0;
     QString bookYUnit = yUnitIn;
     if ( bookYUnit.isEmpty() ) {
         QModelIndex curveYUnitIdx = getDataIndex(curveIdx,"CurveYUnit","Curve");
         bookYUnit = data(curveYUnitIdx).toString();
     }
-    if ( !bookYUnit.isEmpty() && bookYUnit != "--" ) {
-        QString loggedYUnit = curveModel->y()->unit();
-        ys = Unit::scale(loggedYUnit, bookYUnit);
-        yb = Unit::bias(loggedYUnit, bookYUnit);
-    }
     double k = yScaleIn;
     if ( !isUseYScaleIn ) {
         k = getDataDouble(curveIdx,"CurveYScale","Curve");
     }
-    if ( k != 1.0 ) {
-        ys *= k;
-    }
     double b = yBiasIn;
     if ( !isUseYBiasIn ) {
         b = getDataDouble(curveIdx,"CurveYBias","Curve");
     }
-    if ( b != 0.0 ) {
-        yb += b;
-    }
 
     // Get start/stop time
     double start = startTimeIn;
@@ -1311,17 +1424,112 @@ void PlotBookModel::_createPainterPath(const QModelIndex &curveIdx,
         }
     }
 
-    // Create path and cache it
-    if ( _curve2path.contains(curveModel) ) {
-        QPainterPath* currPath = _curve2path.value(curveModel);
-        delete currPath;
-        _curve2path.remove(curveModel);
+    CurvePathSpec spec = curvePathSpec(curveModel,isXTime(plotIdx),
+                                       bookXUnit,j,a,bookYUnit,k,b,
+                                       start,stop,plotXScale,plotYScale);
+    spec.isStatistics = ( plotPresentation(plotIdx) == "statistics" );
+
+    // Use the path built ahead of time (see setCurvePathBuild()) if it
+    // was built from the same spec, else build it now
+    CurvePathBuild* build = _curve2pathBuild.take(curveModel);
+    if ( build && build->spec() != spec ) {
+        delete build;
+        build = 0;
     }
-    QPainterPath* path = __createPainterPath(curveModel,
-                                            (start-tb)/ts,(stop-tb)/ts,
-                                             xs, xb, ys, yb,
-                                            plotXScale, plotYScale);
-    _curve2path.insert(curveModel,path);
+    if ( !build ) {
+        build = new CurvePathBuild(curveModel,spec,
+                                   _curve2timeIndex.take(curveModel));
+        build->build();
+    }
+
+    // Cache the path along with its level-of-detail pyramid, hit test
+    // index and time index (statistics plots only get the time index)
+    delete _curve2path.take(curveModel);
+    delete _curve2lod.take(curveModel);
+    delete _curve2hitIndex.take(curveModel);
+    CurveTimeIndex::release(_curve2timeIndex.take(curveModel));
+    if ( !spec.isStatistics ) {
+        _curve2path.insert(curveModel,build->takePath());
+        _curve2lod.insert(curveModel,build->takeLod());
+        _curve2hitIndex.insert(curveModel,build->takeHitIndex());
+    }
+    _curve2timeIndex.insert(curveModel,build->takeTimeIndex());
+    delete build;
+}
+
+// Path spec of curveModel as if its Curve item had the given units,
+// scales and biases.  The units are the book's (empty or "--" is the
+// logged unit).
+CurvePathSpec PlotBookModel::curvePathSpec(CurveModel *curveModel,
+                                           bool isXTime,
+                                           const QString &xUnit,
+                                           double xScale, double xBias,
+                                           const QString &yUnit,
+                                           double yScale, double yBias,
+                                           double start, double stop,
+                                           const QString &plotXScale,
+                                           const QString &plotYScale) const
+{
+    CurvePathSpec spec;
+
+    // X Curve Scale/bias
+    double xs = 1.0;
+    double xb = 0.0;
+    if ( !xUnit.isEmpty() && xUnit != "--" ) {
+        QString loggedXUnit = curveModel->x()->unit();
+        xs = Unit::scale(loggedXUnit, xUnit);
+        xb = Unit::bias(loggedXUnit, xUnit);
+    }
+    if ( xScale != 1.0 ) {
+        xs *= xScale;
+    }
+    if ( xBias != 0.0 ) {
+        xb += xBias;
+    }
+
+    // Y Curve Scale/Bias
+    double ys = 1.0;
+    double yb = 0.0;
+    if ( !yUnit.isEmpty() && yUnit != "--" ) {
+        QString loggedYUnit = curveModel->y()->unit();
+        ys = Unit::scale(loggedYUnit, yUnit);
+        yb = Unit::bias(loggedYUnit, yUnit);
+    }
+    if ( yScale != 1.0 ) {
+        ys *= yScale;
+    }
+    if ( yBias != 0.0 ) {
+        yb += yBias;
+    }
+
+    // Time shift (and scale), start/stop are in shifted time
+    double tb = 0.0;
+    double ts = 1.0;
+    if ( isXTime ) {
+        tb = xb;
+        ts = xs;
+    }
+
+    spec.startTime = (start-tb)/ts;
+    spec.stopTime = (stop-tb)/ts;
+    spec.xs = xs;
+    spec.xb = xb;
+    spec.ys = ys;
+    spec.yb = yb;
+    spec.plotXScale = plotXScale;
+    spec.plotYScale = plotYScale;
+    spec.frequency = getDataDouble(QModelIndex(),"Frequency");
+
+    return spec;
+}
+
+// Takes ownership of a path built ahead of time, e.g. on a pool thread.
+// It's used when the curve's CurveData is set (if still up to date).
+void PlotBookModel::setCurvePathBuild(CurvePathBuild *build)
+{
+    CurveModel* curveModel = build->curveModel();
+    delete _curve2pathBuild.take(curveModel);
+    _curve2pathBuild.insert(curveModel,build);
 }
 
 // curveIdx0/1 are child indices of "Curves" with tagname "Curve"
@@ -1329,11 +1537,14 @@ void PlotBookModel::_createPainterPath(const QModelIndex &curveIdx,
 // returned path is scaled
 //
 // Note: error paths do not do CurveYScale (or bias)
-QPainterPath* PlotBookModel::_createCurvesErrorPath(
+//
+// The path is cached per curve pair and owned by the model.  The time
+// alignment of the two curves is only redone when their time scale/bias
+// or the match tolerance change, the path when anything else it
+// depends on changes.
+QPainterPath* PlotBookModel::getCurvesErrorPath(
                                             const QModelIndex &curvesIdx) const
 {
-    QPainterPath* path = new QPainterPath;
-
     if ( !isIndex(curvesIdx,"Curves") ) {
         fprintf(stderr,"koviz [bad scoobies]:1:"
                        "PlotBookModel::_createErrorPath()\n");
@@ -1368,9 +1579,12 @@ QPainterPath* PlotBookModel::_createCurvesErrorPath(
     QModelIndex idx0 = index(0,0,curvesIdx);
     QModelIndex idx1 = index(1,0,curvesIdx);
 
-    QString curveXName0 = getDataString(idx0,"CurveXName","Curve");
-    QString curveXUnit0 = getDataString(idx0,"CurveXUnit","Curve");
-    QString curveYUnit0 = getDataString(idx0,"CurveYUnit","Curve");
+    CurveProps props0 = curveProps(idx0);
+    CurveProps props1 = curveProps(idx1);
+
+    QString curveXName0 = props0.xName;
+    QString curveXUnit0 = props0.xUnit;
+    QString curveYUnit0 = props0.yUnit;
     if ( curveXUnit0.isEmpty() || curveXUnit0 == "--" ) {
         curveXUnit0 = c0->x()->unit();
     }
@@ -1378,9 +1592,9 @@ QPainterPath* PlotBookModel::_createCurvesErrorPath(
         curveYUnit0 = c0->y()->unit();
     }
 
-    QString curveXName1 = getDataString(idx1,"CurveXName","Curve");
-    QString curveXUnit1 = getDataString(idx1,"CurveXUnit","Curve");
-    QString curveYUnit1 = getDataString(idx1,"CurveYUnit","Curve");
+    QString curveXName1 = props1.xName;
+    QString curveXUnit1 = props1.xUnit;
+    QString curveYUnit1 = props1.yUnit;
     if ( curveXUnit1.isEmpty() || curveXUnit1 == "--" ) {
         curveXUnit1 = c1->x()->unit();
     }
@@ -1408,15 +1622,15 @@ QPainterPath* PlotBookModel::_createCurvesErrorPath(
         exit(-1);
     }
 
-    QString dpUnits0 = getDataString(idx0,"CurveYUnit","Curve");
-    double ys0 = getDataDouble(idx0,"CurveYScale","Curve");
-    double ys1 = getDataDouble(idx1,"CurveYScale","Curve");
-    double yb0 = getDataDouble(idx0,"CurveYBias","Curve");
-    double yb1 = getDataDouble(idx1,"CurveYBias","Curve");
-    double xb0 = getDataDouble(idx0,"CurveXBias","Curve");
-    double xb1 = getDataDouble(idx1,"CurveXBias","Curve");
-    double xs0 = getDataDouble(idx0,"CurveXScale","Curve");
-    double xs1 = getDataDouble(idx1,"CurveXScale","Curve");
+    QString dpUnits0 = props0.yUnit;
+    double ys0 = props0.yScale;
+    double ys1 = props1.yScale;
+    double yb0 = props0.yBias;
+    double yb1 = props1.yBias;
+    double xb0 = props0.xBias;
+    double xb1 = props1.xBias;
+    double xs0 = props0.xScale;
+    double xs1 = props1.xScale;
     if ( !dpUnits0.isEmpty() ) {
         ys0 *= Unit::scale(c0->y()->unit(),dpUnits0);
         yb0 += Unit::bias(c0->y()->unit(),dpUnits0);
@@ -1445,86 +1659,307 @@ QPainterPath* PlotBookModel::_createCurvesErrorPath(
     bool isXLogScale = ( plotXScale == "log" ) ? true : false;
     bool isYLogScale = ( plotYScale == "log" ) ? true : false;
 
-    c0->map();
-    c1->map();
-    ModelIterator* i0 = c0->begin();
-    ModelIterator* i1 = c1->begin();
+    // Match timestamps
+    QPair<CurveModel*,CurveModel*> key(c0,c1);
+    CurvesErrorCache* cache = _curves2errorCache.value(key,0);
+    if ( !cache ) {
+        cache = new CurvesErrorCache;
+        _curves2errorCache.insert(key,cache);
+    }
+    QString alignKey = QString("%1,%2,%3,%4,%5")
+                       .arg(xs0,0,'g',17).arg(xb0,0,'g',17)
+                       .arg(xs1,0,'g',17).arg(xb1,0,'g',17)
+                       .arg(tolerance,0,'g',17);
+    if ( cache->alignKey != alignKey ) {
+        _alignCurves(c0,xs0,xb0,c1,xs1,xb1,tolerance,cache);
+        cache->alignKey = alignKey;
+        delete cache->path;
+        cache->path = 0;
+    }
+
     double start = getDataDouble(QModelIndex(),"StartTime");
     double stop = getDataDouble(QModelIndex(),"StopTime");
+    QString pathKey = QString("%1,%2,%3,%4,%5,%6,%7,%8")
+                      .arg(ys0,0,'g',17).arg(yb0,0,'g',17)
+                      .arg(ys1,0,'g',17).arg(yb1,0,'g',17)
+                      .arg(start,0,'g',17).arg(stop,0,'g',17)
+                      .arg(plotXScale).arg(plotYScale);
+    if ( cache->path && cache->pathKey == pathKey ) {
+        return cache->path;
+    }
+
+    QPainterPath* path = new QPainterPath;
     bool isFirst = true;
-    while ( !i0->isDone() && !i1->isDone() ) {
-        double t0 = xs0*i0->t()+xb0;
-        double t1 = xs1*i1->t()+xb1;
-        double yy = (ys0*i0->y()+yb0) - (ys1*i1->y()+yb1);
+    int n = cache->ts.size();
+    for ( int i = 0; i < n; ++i ) {
+        double t0 = cache->ts.at(i);
+        double yy = (ys0*cache->y0s.at(i)+yb0) - (ys1*cache->y1s.at(i)+yb1);
+        if ( isYLogScale ) {
+            if ( yy > 0 ) {
+                yy = log10(yy);
+            } else if ( yy < 0 ) {
+                yy = log10(-yy);
+            } else if ( yy == 0 ) {
+                continue; // skip log(0) since -inf
+            }
+        }
+        if ( t0 >= start && t0 <= stop ) {
+            if ( isXLogScale && t0 == 0.0 ) {
+                continue;
+            }
+            if ( isXLogScale ) {
+                t0 = log10(t0);
+            }
+            if ( isFirst ) {
+                path->moveTo(t0,yy);
+                isFirst = false;
+            } else {
+                path->lineTo(t0,yy);
+            }
+        }
+    }
+
+    delete cache->path;
+    cache->path = path;
+    cache->pathKey = pathKey;
+    cache->bbox = path->boundingRect();
+
+    return path;
+}
+
+QRectF PlotBookModel::getCurvesErrorBBox(const QModelIndex &curvesIdx) const
+{
+    getCurvesErrorPath(curvesIdx);  // brings cache up to date
+
+    CurveModel* c0 = getCurveModel(curvesIdx,0);
+    CurveModel* c1 = getCurveModel(curvesIdx,1);
+    QPair<CurveModel*,CurveModel*> key(c0,c1);
+
+    return _curves2errorCache.value(key)->bbox;
+}
+
+CurveStats* PlotBookModel::getCurvesStats(const QModelIndex &curvesIdx) const
+{
+    return _curvesStatsCache(curvesIdx)->stats;
+}
+
+QPainterPath* PlotBookModel::getCurvesStatsPath(const QModelIndex &curvesIdx,
+                                               CurveStats::Band band) const
+{
+    return _curvesStatsCache(curvesIdx)->paths.at(band);
+}
+
+QRectF PlotBookModel::getCurvesStatsBBox(const QModelIndex &curvesIdx) const
+{
+    return _curvesStatsCache(curvesIdx)->bbox;
+}
+
+// Brings the statistics of a plot's curves and their band paths up to
+// date.  The stats are recomputed when the curves, their scales/biases,
+// start/stop or the match tolerance change.  Band paths are rebuilt on
+// log scale changes.
+CurvesStatsCache* PlotBookModel::_curvesStatsCache(
+                                           const QModelIndex &curvesIdx) const
+{
+    QMutexLocker locker(&_curves2statsCacheMutex);
+
+    if ( !isIndex(curvesIdx,"Curves") || rowCount(curvesIdx) < 1 ) {
+        fprintf(stderr,"koviz [bad scoobs]: "
+                       "PlotBookModel::_curvesStatsCache()\n");
+        exit(-1);
+    }
+
+    QModelIndex plotIdx = curvesIdx.parent();
+    if ( !isXTime(plotIdx) ) {
+        // plotPresentation() presents these as "compare"
+        fprintf(stderr,"koviz [bad scoobs]: PlotBookModel::_curvesStatsCache() "
+                       "called for a plot whose x is not time\n");
+        exit(-1);
+    }
+
+    double start = getDataDouble(QModelIndex(),"StartTime");
+    double stop = getDataDouble(QModelIndex(),"StopTime");
+    double tolerance = getDataDouble(QModelIndex(),"TimeMatchTolerance");
+
+    QList<CurveStatsInput> inputs;
+    QByteArray statsKey;
+    int rc = rowCount(curvesIdx);
+    for ( int i = 0; i < rc; ++i ) {
+        QModelIndex curveIdx = index(i,0,curvesIdx);
+        CurveStatsInput in;
+        in.curve = getCurveModel(curveIdx);
+        if ( !in.curve ) {
+            continue;
+        }
+        in.xs = xScale(curveIdx,in.curve);
+        in.xb = xBias(curveIdx,in.curve);
+        in.ys = yScale(curveIdx);
+        in.yb = yBias(curveIdx);
+        inputs.append(in);
+        statsKey.append((const char*)&in.curve,sizeof(in.curve));
+        statsKey.append((const char*)&in.xs,sizeof(double));
+        statsKey.append((const char*)&in.xb,sizeof(double));
+        statsKey.append((const char*)&in.ys,sizeof(double));
+        statsKey.append((const char*)&in.yb,sizeof(double));
+    }
+    statsKey.append((const char*)&start,sizeof(double));
+    statsKey.append((const char*)&stop,sizeof(double));
+    statsKey.append((const char*)&tolerance,sizeof(double));
+
+    CurveModel* c0 = getCurveModel(curvesIdx,0);
+    CurvesStatsCache* cache = _curves2statsCache.value(c0,0);
+    if ( !cache ) {
+        cache = new CurvesStatsCache;
+        _curves2statsCache.insert(c0,cache);
+    }
+    if ( !cache->stats || cache->statsKey != statsKey ) {
+        delete cache->stats;
+        cache->stats = new CurveStats(inputs,start,stop,tolerance);
+        cache->statsKey = statsKey;
+        cache->curves.clear();
+        foreach ( CurveStatsInput in, inputs ) {
+            cache->curves.append(in.curve);
+        }
+        qDeleteAll(cache->paths);
+        cache->paths.clear();
+    }
+
+    QString plotXScale = getDataString(plotIdx,"PlotXScale","Plot");
+    QString plotYScale = getDataString(plotIdx,"PlotYScale","Plot");
+    QString pathKey = plotXScale + "," + plotYScale;
+    if ( !cache->paths.isEmpty() && cache->pathKey == pathKey ) {
+        return cache;
+    }
+    bool isXLogScale = ( plotXScale == "log" ) ? true : false;
+    bool isYLogScale = ( plotYScale == "log" ) ? true : false;
+
+    qDeleteAll(cache->paths);
+    cache->paths.clear();
+    cache->bbox = QRectF();
+    CurveStats* stats = cache->stats;
+    int n = stats->count();
+    for ( int b = 0; b < CurveStats::NumBands; ++b ) {
+        CurveStats::Band band = (CurveStats::Band) b;
+        QPainterPath* path = new QPainterPath;
+        bool isFirst = true;
+        for ( int i = 0; i < n; ++i ) {
+            double t = stats->times().at(i);
+            double yy = stats->bandValue(band,i);
+            if ( qIsNaN(yy) ) {
+                isFirst = true;  // no curve has this time, leave a gap
+                continue;
+            }
+            if ( isYLogScale ) {
+                if ( yy > 0 ) {
+                    yy = log10(yy);
+                } else if ( yy < 0 ) {
+                    yy = log10(-yy);
+                } else if ( yy == 0 ) {
+                    continue; // skip log(0) since -inf
+                }
+            }
+            if ( isXLogScale ) {
+                if ( t == 0.0 ) {
+                    continue;
+                }
+                t = log10(t);
+            }
+            if ( isFirst ) {
+                path->moveTo(t,yy);
+                isFirst = false;
+            } else {
+                path->lineTo(t,yy);
+            }
+        }
+        cache->paths.append(path);
+        if ( path->elementCount() > 0 ) {
+            QRectF pathBox = path->boundingRect();
+            if ( cache->bbox.isNull() ) {
+                cache->bbox = pathBox;
+            } else {
+                cache->bbox = cache->bbox.united(pathBox);
+            }
+        }
+    }
+    cache->pathKey = pathKey;
+
+    return cache;
+}
+
+// Pairs each timestamp of c0 with c1's nearest and keeps the pairs that
+// are within tolerance
+void PlotBookModel::_alignCurves(CurveModel *c0, double xs0, double xb0,
+                                 CurveModel *c1, double xs1, double xb1,
+                                 double tolerance,
+                                 CurvesErrorCache *cache) const
+{
+    cache->ts.clear();
+    cache->y0s.clear();
+    cache->y1s.clear();
+
+    c0->map();
+    c1->map();
+    int n0 = c0->rowCount();
+    int n1 = c1->rowCount();
+    QVector<double> t0s(n0);
+    QVector<double> y0s(n0);
+    QVector<double> t1s(n1);
+    QVector<double> y1s(n1);
+    c0->fill(0,n0,t0s.data(),0,y0s.data());
+    c1->fill(0,n1,t1s.data(),0,y1s.data());
+    c0->unmap();
+    c1->unmap();
+
+    int i0 = 0;
+    int i1 = 0;
+    while ( i0 < n0 && i1 < n1 ) {
+        double t0 = xs0*t0s.at(i0)+xb0;
+        double t1 = xs1*t1s.at(i1)+xb1;
+        int j0 = i0;  // matched pair
+        int j1 = i1;
         // Match timestamps as close as possible (freq not used)
         if ( t0 == t1 ) {
-            i0->next();
-            i1->next();
+            ++i0;
+            ++i1;
         } else if ( t0 < t1 ) {
-            i0->next();
-            while ( !i0->isDone() ) {
-                double t00 = xs0*i0->t()+xb0;
+            ++i0;
+            while ( i0 < n0 ) {
+                double t00 = xs0*t0s.at(i0)+xb0;
                 double dtt = qAbs(t1-t00);
                 if ( dtt < qAbs(t0-t1) ) {
                     t0 = t00;
-                    yy = (ys0*i0->y()+yb0) - (ys1*i1->y()+yb1);
-                    i0->next();
+                    j0 = i0;
+                    ++i0;
                 } else {
                     break;
                 }
             }
-            i1->next();
+            ++i1;
         } else if ( t0 > t1 ) {
-            i1->next();
-            while ( !i1->isDone() ) {
-                double t11 = xs1*i1->t()+xb1;
+            ++i1;
+            while ( i1 < n1 ) {
+                double t11 = xs1*t1s.at(i1)+xb1;
                 double dtt = qAbs(t0-t11);
                 if ( dtt < qAbs(t1-t0) ) {
                     t1 = t11;
-                    yy = (ys0*i0->y()+yb0) - (ys1*i1->y()+yb1);
-                    i1->next();
+                    j1 = i1;
+                    ++i1;
                 } else {
                     break;
                 }
             }
-            i0->next();
+            ++i0;
         } else {
             // bad scoobs, but step to avoid inf loop
-            i0->next();
-            i1->next();
+            ++i0;
+            ++i1;
         }
         if ( qAbs(t1-t0) <= tolerance ) {
-            if ( isYLogScale ) {
-                if ( yy > 0 ) {
-                    yy = log10(yy);
-                } else if ( yy < 0 ) {
-                    yy = log10(-yy);
-                } else if ( yy == 0 ) {
-                    continue; // skip log(0) since -inf
-                }
-            }
-            if ( t0 >= start && t0 <= stop ) {
-                if ( isXLogScale && t0 == 0.0 ) {
-                    continue;
-                }
-                if ( isXLogScale ) {
-                    t0 = log10(t0);
-                }
-                if ( isFirst ) {
-                    path->moveTo(t0,yy);
-                    isFirst = false;
-                } else {
-                    path->lineTo(t0,yy);
-                }
-            }
+            cache->ts.append(t0);
+            cache->y0s.append(y0s.at(j0));
+            cache->y1s.append(y1s.at(j1));
         }
     }
-    delete i0;
-    delete i1;
-    c0->unmap();
-    c1->unmap();
-
-    return path;
 }
 
 // If all curves have same unit, return that, else return "--"
@@ -1542,13 +1977,13 @@ QString PlotBookModel::getCurvesXUnit(const QModelIndex &curvesIdx)
 
     if ( rc >= 1 ) {
         QModelIndex curve0Idx = index(0,0,curvesIdx);
-        QString xunit0 = getDataString(curve0Idx,"CurveXUnit","Curve");
+        QString xunit0 = curveProps(curve0Idx).xUnit;
         if ( xunit0 == "--" || xunit0.isEmpty() ) {
             xunit0 = getCurveModel(curve0Idx)->x()->unit();
         }
         for (int i = 0; i < rc; ++i) {
             QModelIndex curveIdx = index(i,0,curvesIdx);
-            xunit = getDataString(curveIdx,"CurveXUnit","Curve");
+            xunit = curveProps(curveIdx).xUnit;
             if ( xunit == "--" || xunit.isEmpty() ) {
                 CurveModel* curveModel = getCurveModel(curveIdx);
                 xunit = curveModel->x()->unit();
@@ -1581,13 +2016,13 @@ QString PlotBookModel::getCurvesYUnit(const QModelIndex &curvesIdx)
 
     if ( rc > 0 ) {
         QModelIndex curve0Idx = index(0,0,curvesIdx);
-        QString yunit0 = getDataString(curve0Idx,"CurveYUnit","Curve");
+        QString yunit0 = curveProps(curve0Idx).yUnit;
         if ( yunit0.isEmpty() ) {
             yunit0 = getCurveModel(curve0Idx)->y()->unit();
         }
         for (int i = 0; i < rc; ++i) {
             QModelIndex curveIdx = index(i,0,curvesIdx);
-            yunit = getDataString(curveIdx,"CurveYUnit","Curve");
+            yunit = curveProps(curveIdx).yUnit;
             if ( yunit.isEmpty() ) {
                 CurveModel* curveModel = getCurveModel(curveIdx);
                 yunit = curveModel->y()->unit();
@@ -1602,6 +2037,18 @@ QString PlotBookModel::getCurvesYUnit(const QModelIndex &curvesIdx)
     return yunit;
 }
 
+// The plot's presentation as drawn.  Statistics are only computed over
+// time, so a "statistics" plot (e.g. from -pres or a session) whose x is
+// not time is presented as "compare".
+QString PlotBookModel::plotPresentation(const QModelIndex &plotIdx) const
+{
+    QString presentation = getDataString(plotIdx,"PlotPresentation","Plot");
+    if ( presentation == "statistics" && !isXTime(plotIdx) ) {
+        presentation = "compare";
+    }
+    return presentation;
+}
+
 // If *any* of the curves in plot has a curve with x being time, return true
 bool PlotBookModel::isXTime(const QModelIndex &plotIdx) const
 {
@@ -1614,9 +2061,8 @@ bool PlotBookModel::isXTime(const QModelIndex &plotIdx) const
         int rc = rowCount(curvesIdx);
         for ( int i = 0; i < rc ; ++i ) {
             QModelIndex curveIdx = index(i,0,curvesIdx);
-            QString xName = getDataString(curveIdx, "CurveXName","Curve");
-            QString tName = getDataString(curveIdx, "CurveTimeName","Curve");
-            if ( xName == tName ) {
+            CurveProps props = curveProps(curveIdx);
+            if ( props.xName == props.timeName ) {
                 isXTime = true;
                 break;
             }
@@ -2472,9 +2918,10 @@ QList<PlotBookModel::LegendElement> PlotBookModel::_legendElements(
 
     QStringList labels;
     foreach (QModelIndex curveIdx, curveIdxs) {
-        QString lbl = getDataString(curveIdx,"CurveYLabel","Curve");
+        CurveProps props = curveProps(curveIdx);
+        QString lbl = props.yLabel;
         if ( lbl.isEmpty() ) {
-            lbl = getDataString(curveIdx,"CurveYName","Curve");
+            lbl = props.yName;
         }
         labels << lbl;
         if ( !isOverrides && labels.size() > overrides.size() ) {
@@ -2504,9 +2951,10 @@ QList<PlotBookModel::LegendElement> PlotBookModel::_legendElements(
     foreach (QModelIndex curveIdx, curveIdxs) {
         PlotBookModel::LegendElement el;
         el.label = labels.at(i);
-        el.color = getDataString(curveIdx,"CurveColor","Curve");
-        el.linestyle = getDataString(curveIdx, "CurveLineStyle","Curve");
-        el.symbolstyle = getDataString(curveIdx,"CurveSymbolStyle","Curve");
+        CurveProps props = curveProps(curveIdx);
+        el.color = props.color;
+        el.linestyle = props.lineStyle;
+        el.symbolstyle = props.symbolStyle;
 #if QT_VERSION >= 0x050000
         if ( !elHash.contains(el) ) {
             elHash.insert(el,1);
@@ -2515,7 +2963,7 @@ QList<PlotBookModel::LegendElement> PlotBookModel::_legendElements(
 #endif
             els << el;
             if ( isGroups ) {
-                int runid = getDataInt(curveIdx,"CurveRunID","Curve");
+                int runid = props.runID;
                 QString runDir = _runs->runDirs().at(runid);
                 int j = 0;
                 foreach ( QString group, groups ) {
@@ -10,6 +10,11 @@
 #include <QPaintEngine>
 #include <QString>
 #include <QStringList>
+#include <QPair>
+#include <QByteArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QReadWriteLock>
 #if QT_VERSION >= 0x050000
 #include <QRegularExpressionMatch>
 #include <QHashFunctions>
@@ -18,11 +23,62 @@
 #include "unit.h"
 #include "utils.h"
 #include "curvemodel.h"
+#include "curvelod.h"
+#include "curvehitindex.h"
+#include "curvetimeindex.h"
+#include "curvestats.h"
+#include "curvepathbuild.h"
+#include "curveprops.h"
 
 #include <QList>
 #include <QColor>
 #include <cmath>
 
+// Error curve (c0-c1) of a two curve plot and the time alignment it is
+// built from.  The keys record what each was computed with.
+class CurvesErrorCache
+{
+  public:
+    CurvesErrorCache() : path(0) {}
+    ~CurvesErrorCache() { delete path; }
+
+    QString alignKey;      // time scales/biases and match tolerance
+    QVector<double> ts;    // matched times (curve 0's, scaled)
+    QVector<double> y0s;   // unscaled y of each curve at the matched times
+    QVector<double> y1s;
+
+    QString pathKey;       // y scales/biases, start/stop and log scales
+    QPainterPath* path;
+    QRectF bbox;           // path's bounding box
+};
+
+// Statistics of a statistics plot's curves and the band paths drawn
+// from them.  The keys record what each was computed with.
+class CurvesStatsCache
+{
+  public:
+    CurvesStatsCache() : stats(0) {}
+    ~CurvesStatsCache() { delete stats; qDeleteAll(paths); }
+
+    QByteArray statsKey;   // curves, scales/biases, start/stop, tolerance
+    QList<CurveModel*> curves;    // curves stats was computed from
+    CurveStats* stats;
+
+    QString pathKey;       // log scales
+    QList<QPainterPath*> paths;   // one per CurveStats::Band
+    QRectF bbox;           // bounding box of all bands
+};
+
+// Rows of an item's children by tag (first row if a tag repeats) and the
+// row count they were hashed at
+class BookTagRows
+{
+  public:
+    BookTagRows() : rowCount(-1) {}
+    int rowCount;
+    QHash<QString,int> rows;
+};
+
 class PlotBookModel : public QStandardItemModel
 {
     Q_OBJECT
@@ -35,6 +91,8 @@ public:
 
     virtual bool setData(const QModelIndex &idx,
                          const QVariant &value, int role=Qt::EditRole);
+    virtual bool removeRows(int row, int count,
+                            const QModelIndex &parent=QModelIndex());
 
 public:
     double xScale(const QModelIndex& curveIdx,CurveModel* curveModelIn=0) const;
@@ -42,6 +100,8 @@ public:
     double xBias(const QModelIndex& curveIdx, CurveModel* curveModelIn=0) const;
     double yBias(const QModelIndex& curveIdx) const;
     QRectF calcCurvesBBox(const QModelIndex& curvesIdx) const;
+    bool calcCurvesYRange(const QModelIndex& curvesIdx, double x0, double x1,
+                          double* yMin, double* yMax) const;
 
     QStandardItem* addChild(QStandardItem* parentItem,
                             const QString& childTitle,
@@ -90,14 +150,33 @@ public:
 
     CurveModel* createCurve(int row, const QString& tName,
                             const QString& xName, const QString& yName);
+    CurvePathSpec curvePathSpec(CurveModel* curveModel, bool isXTime,
+                                const QString& xUnit,
+                                double xScale, double xBias,
+                                const QString& yUnit,
+                                double yScale, double yBias,
+                                double start, double stop,
+                                const QString& plotXScale,
+                                const QString& plotYScale) const;
+    void setCurvePathBuild(CurvePathBuild* build);
+    CurveProps curveProps(const QModelIndex& curveIdx) const;
     CurveModel* getCurveModel(const QModelIndex& curvesIdx, int i) const;
     CurveModel* getCurveModel(const QModelIndex& curveIdx) const;
 
     QPainterPath* getPainterPath(const QModelIndex& curveIdx) const;
-    QPainterPath* getCurvesErrorPath(const QModelIndex& curvesIdx);
+    CurveLod* getCurveLod(const QModelIndex& curveIdx) const;
+    CurveHitIndex* getCurveHitIndex(const QModelIndex& curveIdx) const;
+    CurveTimeIndex* getCurveTimeIndex(const QModelIndex& curveIdx) const;
+    QPainterPath* getCurvesErrorPath(const QModelIndex& curvesIdx) const;
+    QRectF getCurvesErrorBBox(const QModelIndex& curvesIdx) const;
+    CurveStats* getCurvesStats(const QModelIndex& curvesIdx) const;
+    QPainterPath* getCurvesStatsPath(const QModelIndex& curvesIdx,
+                                     CurveStats::Band band) const;
+    QRectF getCurvesStatsBBox(const QModelIndex& curvesIdx) const;
     QString getCurvesXUnit(const QModelIndex& curvesIdx);
     QString getCurvesYUnit(const QModelIndex& curvesIdx);
     bool isXTime(const QModelIndex& plotIdx) const;
+    QString plotPresentation(const QModelIndex& plotIdx) const;
 
     QModelIndexList getIndexList(const QModelIndex& startIdx,
                         const QString& searchItemText,
@@ -112,6 +191,8 @@ public:
     QList<QColor> createCurveColors(int nCurves);
     QColor errorLineColor() const;
     QColor flatLineColor() const;
+    QColor statsBandColor(CurveStats::Band band) const;
+    QString statsBandLineStyle(CurveStats::Band band) const;
 
     // Convenience wrappers for get/setting PlotMathRect
     QRectF getPlotMathRect(const QModelIndex &plotIdx) const;
@@ -158,6 +239,9 @@ private:
                         const QString &expectedStartIdxText=QString()) const;
 
     QHash<CurveModel*,QPainterPath*> _curve2path;
+    QHash<CurveModel*,CurveLod*> _curve2lod;
+    QHash<CurveModel*,CurveHitIndex*> _curve2hitIndex;
+    QHash<CurveModel*,CurveTimeIndex*> _curve2timeIndex;
     void _createPainterPath(const QModelIndex& curveIdx,
                             bool isUseStartTimeIn, double startTimeIn,
                             bool isUseStopTimeIn, double stopTimeIn,
@@ -170,13 +254,24 @@ private:
                             const QString& plotXScaleIn=QString(""),
                             const QString& plotYScaleIn=QString(""),
                             CurveModel* curveModelIn=0);
-    QPainterPath* __createPainterPath(CurveModel *curveModel,
-                                      double startTime, double stopTime,
-                                      double xs, double xb,
-                                      double ys, double yb,
-                                      const QString& plotXScale,
-                                      const QString& plotYScale);
-    QPainterPath* _createCurvesErrorPath(const QModelIndex& curvesIdx) const;
+    QHash<CurveModel*,CurvePathBuild*> _curve2pathBuild;
+    mutable QMutex _curvePropsMutex;  // guards CurveItem props refills
+    mutable QHash<const QStandardItem*,BookTagRows> _item2tagRows;
+    mutable QReadWriteLock _tagRowsLock;
+    int _childRow(const QModelIndex& pidx, const QString& tag) const;
+    void _clearTagRows();
+    void _setCurvePropsDirty(const QModelIndex& idx);
+    mutable QHash<QPair<CurveModel*,CurveModel*>,
+                  CurvesErrorCache*> _curves2errorCache;
+    void _alignCurves(CurveModel* c0, double xs0, double xb0,
+                      CurveModel* c1, double xs1, double xb1,
+                      double tolerance, CurvesErrorCache* cache) const;
+    mutable QHash<CurveModel*,CurvesStatsCache*> _curves2statsCache;
+    mutable QMutex _curves2statsCacheMutex;
+    CurvesStatsCache* _curvesStatsCache(const QModelIndex& curvesIdx) const;
+    void _curveModels(const QModelIndex& idx,
+                      QList<CurveModel*>* curveModels) const;
+    void _removeCurveCaches(CurveModel* curveModel);
 
     QString _commonRootName(const QStringList& names, const QString& sep) const;
     QString __commonRootName(const QString& a, const QString& b,
@@ -1,7 +1,8 @@
 #include "bookview.h"
 
 BookView::BookView(QWidget *parent) :
-    BookIdxView(parent)
+    BookIdxView(parent),
+    _printThreadCount(0)
 {
     _mainLayout = new QVBoxLayout;
 
@@ -118,6 +119,67 @@ QModelIndex BookView::_tabIdToModelIdx(int tabId)
 }
 
 
+// Number of threads savePdf() paints pages on.  Zero (the default) is
+// one per core.
+void BookView::setPrintThreadCount(int nThreads)
+{
+    _printThreadCount = nThreads;
+}
+
+//
+// Which pages' pictures are painted (see savePdf())
+//
+class PagePrintProgress
+{
+  public:
+    PagePrintProgress(int nPages) : isDone(nPages,false) {}
+
+    QMutex mutex;
+    QWaitCondition pageDone;
+    QVector<bool> isDone;
+};
+
+//
+// Paints a page, laid out on the GUI thread, into a PagePicture on a
+// pool thread (see savePdf())
+//
+class PagePrintTask : public QRunnable
+{
+  public:
+    PagePrintTask(BookView* bookView, const QModelIndex& pageIdx,
+                  const PagePrintLayout* layout,
+                  PagePicture* picture, double penWidth,
+                  PagePrintProgress* progress, int page) :
+        _bookView(bookView), _pageIdx(pageIdx), _layout(layout),
+        _picture(picture), _penWidth(penWidth),
+        _progress(progress), _page(page) {}
+
+    void run()
+    {
+        QPainter painter;
+        if ( painter.begin(_picture) ) {
+            QPen pen((QColor(Qt::black)));
+            pen.setWidthF(_penWidth);
+            painter.setPen(pen);
+            _bookView->_paintPage(&painter,_pageIdx,_layout);
+            painter.end();
+        }
+
+        QMutexLocker locker(&_progress->mutex);
+        _progress->isDone[_page] = true;
+        _progress->pageDone.wakeAll();
+    }
+
+  private:
+    BookView* _bookView;
+    QModelIndex _pageIdx;
+    const PagePrintLayout* _layout;
+    PagePicture* _picture;
+    double _penWidth;
+    PagePrintProgress* _progress;
+    int _page;
+};
+
 void BookView::savePdf(const QString &fname)
 {
     //
@@ -157,23 +219,91 @@ void BookView::savePdf(const QString &fname)
     painter.setPen(pen);
 
     //
-    // Print pages
+    // Pages to print (i.e. not tables)
     //
-    bool isFirst = true;
+    QModelIndexList pageIdxs;
     int nTabs = _nb->count();
     for ( int i = 0; i < nTabs; ++i) {
-
         QModelIndex idx = _tabIdToModelIdx(i);
         QString tag = model()->data(idx).toString();
-        if ( tag != "Page") {
-            continue; // only print pages (i.e. not tables)
+        if ( tag == "Page") {
+            pageIdxs << idx;
         }
-        if ( isFirst ) {
-            isFirst = false;
-        } else {
-            printer.newPage();
+    }
+
+    //
+    // Print pages
+    //
+    // With more than one page and thread, pages are laid out for the
+    // printer on this (the GUI) thread, then painted on pool threads into
+    // pictures.  A picture is played back onto the printer as soon as it
+    // and the pages before it are painted.  At most two pages per thread
+    // are in flight, and no more are started while pictures waiting on an
+    // earlier page hold more than maxWaitingBytes.  Pages are painted
+    // serially when the platform can't render fonts off the GUI thread.
+    //
+    QThreadPool pool;
+    if ( _printThreadCount > 0 ) {
+        pool.setMaxThreadCount(_printThreadCount);
+    }
+    int nThreads = pool.maxThreadCount();
+    int nPages = pageIdxs.size();
+    if ( nPages <= 1 || nThreads <= 1 ||
+         !QFontDatabase::supportsThreadedFontRendering() ) {
+        for ( int i = 0; i < nPages; ++i ) {
+            if ( i > 0 ) {
+                printer.newPage();
+            }
+            _printPage(&painter,pageIdxs.at(i));
+        }
+    } else {
+        const qint64 maxWaitingBytes = 256LL*1024LL*1024LL;
+        int maxInFlight = 2*nThreads;
+        PagePrintProgress progress(nPages);
+        QVector<PagePrintLayout*> layouts(nPages,0);
+        QVector<PagePicture*> pictures(nPages,0);
+        int nStarted = 0;
+        for ( int i = 0; i < nPages; ++i ) {
+
+            // Keep the pool busy with the pages after this one
+            while ( nStarted < nPages && nStarted-i < maxInFlight ) {
+                if ( nStarted > i+1 ) {
+                    qint64 waitingBytes = 0;
+                    QMutexLocker locker(&progress.mutex);
+                    for ( int j = i; j < nStarted; ++j ) {
+                        if ( progress.isDone.at(j) ) {
+                            waitingBytes += pictures.at(j)->size();
+                        }
+                    }
+                    if ( waitingBytes > maxWaitingBytes ) {
+                        break;
+                    }
+                }
+                layouts[nStarted] = _layoutPage(&painter,
+                                                pageIdxs.at(nStarted));
+                pictures[nStarted] = new PagePicture(&printer);
+                pool.start(new PagePrintTask(this,pageIdxs.at(nStarted),
+                                             layouts.at(nStarted),
+                                             pictures.at(nStarted),pointSize,
+                                             &progress,nStarted));
+                ++nStarted;
+            }
+
+            progress.mutex.lock();
+            while ( !progress.isDone.at(i) ) {
+                progress.pageDone.wait(&progress.mutex);
+            }
+            progress.mutex.unlock();
+
+            if ( i > 0 ) {
+                printer.newPage();
+            }
+            painter.drawPicture(0,0,*pictures.at(i));
+            delete pictures.at(i);
+            delete layouts.at(i);
+            pictures[i] = 0;
         }
-        _printPage(&painter,idx);
+        pool.waitForDone();
     }
 
     //
@@ -217,33 +347,51 @@ void BookView::saveJpg(const QString &fname)
 
 void BookView::_printPage(QPainter *painter, const QModelIndex& pageIdx)
 {
-    QPaintDevice* paintDevice = painter->device();
-    if ( !paintDevice ) return;
+    PagePrintLayout* layout = _layoutPage(painter,pageIdx);
+    if ( !layout ) return;
+    _paintPage(painter,pageIdx,layout);
+    delete layout;
+}
 
-    painter->save();
+PagePrintLayout::PagePrintLayout() :
+    pageTitleLayoutItem(0)
+{
+}
 
-    // Foreground
-    QPen origPen = painter->pen();
-    QColor fg = _bookModel()->pageForegroundColor(pageIdx);
-    QPen pagePen = painter->pen();
-    pagePen.setColor(fg);
-    painter->setPen(pagePen);
+PagePrintLayout::~PagePrintLayout()
+{
+    int nItems = pageLayout.count();
+    for ( int i = 0; i < nItems; ++i ) {
+        QLayoutItem* item = pageLayout.itemAt(i);
+        if ( item->layout() ) {
+            for ( int j = 0; j < item->layout()->count(); ++j ) {
+                delete item->layout()->itemAt(j);
+            }
+        }
+        delete item;
+    }
+}
 
-    // Background
-    QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
-    painter->fillRect(QRect(0,0,paintDevice->width(),paintDevice->height()),bg);
+// Builds the page and plot layouts and sets their geometry for the
+// painter's device.  The layouts are QLayouts, so this runs on the GUI
+// thread.  Returns 0 if the painter has no device.
+PagePrintLayout* BookView::_layoutPage(QPainter *painter,
+                                       const QModelIndex& pageIdx)
+{
+    QPaintDevice* paintDevice = painter->device();
+    if ( !paintDevice ) return 0;
+
+    PagePrintLayout* layout = new PagePrintLayout;
 
     // Load page and plot layouts
-    PageLayout pageLayout;
+    PageLayout& pageLayout = layout->pageLayout;
     pageLayout.setModelIndex(_bookModel(),pageIdx);
-    PageTitleLayoutItem* pageTitleLayoutItem = new PageTitleLayoutItem(
-                                                  _bookModel(),pageIdx,
-                                                  painter->font());
-    pageLayout.addItem(pageTitleLayoutItem);
+    layout->pageTitleLayoutItem = new PageTitleLayoutItem(_bookModel(),pageIdx,
+                                                          painter->font());
+    pageLayout.addItem(layout->pageTitleLayoutItem);
     QModelIndex plotsIdx = _bookModel()->getIndex(pageIdx,"Plots", "Page");
     QModelIndexList plotIdxs = _bookModel()->plotIdxs(pageIdx);
     int nPlots = model()->rowCount(plotsIdx);
-    QHash<QLayout*,QRectF> plotlayout2mathrect;
     QFontMetrics fm = painter->fontMetrics();
     QFont font8 = painter->font();
     font8.setPointSizeF(8);
@@ -258,7 +406,7 @@ void BookView::_printPage(QPainter *painter, const QModelIndex& pageIdx)
                                                         "PlotRatio","Plot");
         plotLayout->setPlotRatio(plotRatio);
         QRectF M = _bookModel()->getPlotMathRect(plotIdx);
-        plotlayout2mathrect.insert(plotLayout,M);
+        layout->plotlayout2mathrect.insert(plotLayout,M);
         QLayoutItem* item = new YAxisLabelLayoutItem(fm,_bookModel(),plotIdx);
         plotLayout->addItem(item);  // yAxisLabel
         item = new TicLabelsLayoutItem(fm,fm8,_bookModel(),plotIdx);
@@ -299,10 +447,35 @@ void BookView::_printPage(QPainter *painter, const QModelIndex& pageIdx)
     int hh = qRound((double)paintDevice->height()/pixelRatio);
     pageLayout.setGeometry(QRect(0,0,ww,hh));
 
+    return layout;
+}
+
+// Paints a page laid out by _layoutPage().  Only reads the layouts, so
+// pages may be painted on pool threads.
+void BookView::_paintPage(QPainter *painter, const QModelIndex& pageIdx,
+                          const PagePrintLayout* layout)
+{
+    QPaintDevice* paintDevice = painter->device();
+    if ( !paintDevice ) return;
+
+    painter->save();
+
+    // Foreground
+    QPen origPen = painter->pen();
+    QColor fg = _bookModel()->pageForegroundColor(pageIdx);
+    QPen pagePen = painter->pen();
+    pagePen.setColor(fg);
+    painter->setPen(pagePen);
+
+    // Background
+    QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
+    painter->fillRect(QRect(0,0,paintDevice->width(),paintDevice->height()),bg);
+
     // Print layouts
     //QColor green(0,255,0);
     //QPen greenPen(green);
     painter->setPen(pagePen);
+    const PageLayout& pageLayout = layout->pageLayout;
     int nItems = pageLayout.count();
     for ( int i = 0; i < nItems; ++i ) {
         QLayoutItem* item = pageLayout.itemAt(i);
@@ -315,7 +488,7 @@ void BookView::_printPage(QPainter *painter, const QModelIndex& pageIdx)
             QLayout* plotLayout= item->layout();
             QRect C = plotLayout->itemAt(3)->geometry();
             C.translate(parentRect.x(),parentRect.y());
-            QRectF M = plotlayout2mathrect.value(plotLayout);
+            QRectF M = layout->plotlayout2mathrect.value(plotLayout);
             for ( int j = 0; j < plotLayout->count(); ++j ) {
                 QLayoutItem* childItem = plotLayout->itemAt(j);
                 QRect R = childItem->geometry();
@@ -331,22 +504,11 @@ void BookView::_printPage(QPainter *painter, const QModelIndex& pageIdx)
             }
         }
     }
-    QRect R = pageTitleLayoutItem->geometry();
+    QRect R = layout->pageTitleLayoutItem->geometry();
     QRect RG;
     QRect C;
     QRect M;
-    pageTitleLayoutItem->paint(painter,R,RG,C,M);
-
-    // Clean up
-    for ( int i = 0; i < nItems; ++i ) {
-        QLayoutItem* item = pageLayout.itemAt(i);
-        if ( item->layout() ) {
-            for ( int j = 0; j < item->layout()->count(); ++j ) {
-                delete item->layout()->itemAt(j);
-            }
-        }
-        delete item;
-    }
+    layout->pageTitleLayoutItem->paint(painter,R,RG,C,M);
 
     painter->setPen(origPen);
     painter->restore();
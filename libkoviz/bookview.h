@@ -18,6 +18,12 @@
 #include <QVector2D>
 #include <QPolygonF>
 #include <QHash>
+#include <QPicture>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
 #include <math.h>
 
 #include "bookidxview.h"
@@ -36,12 +42,27 @@
 #include "layoutitem_ticlabels.h"
 #include "layoutitem_xaxislabel.h"
 #include "layoutitem_curves.h"
+#include "pagepicture.h"
+
+// A page's layouts with their geometry set for a paint device.  Built
+// on the GUI thread, then only read while the page is painted.
+class PagePrintLayout
+{
+  public:
+    PagePrintLayout();
+    ~PagePrintLayout();
+
+    PageLayout pageLayout;
+    PageTitleLayoutItem* pageTitleLayoutItem;
+    QHash<QLayout*,QRectF> plotlayout2mathrect;
+};
 
 class BookView : public BookIdxView
 {
     Q_OBJECT
 public:
     explicit BookView(QWidget *parent = 0);
+    void setPrintThreadCount(int nThreads);
 
 protected:
     virtual void currentChanged(const QModelIndex& current,
@@ -52,11 +73,17 @@ protected:
 private:
     QVBoxLayout* _mainLayout;
     QTabWidget* _nb;
+    int _printThreadCount;
     int _modelIdxToTabId(const QModelIndex& idx);
     QModelIndex _tabIdToModelIdx(int tabId);
 
 private:
     void _printPage(QPainter* painter, const QModelIndex& pageIdx);
+    PagePrintLayout* _layoutPage(QPainter* painter,
+                                 const QModelIndex& pageIdx);
+    void _paintPage(QPainter* painter, const QModelIndex& pageIdx,
+                    const PagePrintLayout* layout);
+    friend class PagePrintTask;
 
 public slots:
     void savePdf(const QString& fname);
@@ -317,20 +317,27 @@ void CoordArrow::paintMeCenter(QPainter &painter,
 
 CurvesView::CurvesView(QWidget *parent) :
     BookIdxView(parent),
-    _pixmap(0)
+    _renderer(new CurvesRenderer(this)),
+    _isRenderPending(false),
+    _isPendingPan(false),
+    _panSettleTimer(new QTimer(this))
 {
     setFocusPolicy(Qt::StrongFocus);
     setFrameShape(QFrame::NoFrame);
 
     // Set mouse tracking to receive mouse move events when button not pressed
     setMouseTracking(true);
+
+    connect(_renderer,SIGNAL(rendered(QImage,QTransform)),
+            this,SLOT(_liveImageRendered(QImage,QTransform)));
+
+    _panSettleTimer->setSingleShot(true);
+    _panSettleTimer->setInterval(150);
+    connect(_panSettleTimer,SIGNAL(timeout()),this,SLOT(_panSettled()));
 }
 
 CurvesView::~CurvesView()
 {
-    if ( _pixmap ) {
-        delete _pixmap;
-    }
     foreach ( TimeAndIndex* marker, _markers ) {
         delete marker;
     }
@@ -352,7 +359,7 @@ void CurvesView::setCurrentCurveRunID(int runID)
     for (int i = 0 ; i < rc; ++i ) {
         QModelIndex idx = model()->index(i,0,curvesIdx);
         if ( model()->data(idx).toString() == "Curve" ) {
-            int curveRunID = _bookModel()->getDataInt(idx,"CurveRunID","Curve");
+            int curveRunID = _bookModel()->curveProps(idx).runID;
             if ( curveRunID == runID ) {
                 ++nMatches;
                 curveIdx = idx;
@@ -402,22 +409,24 @@ void CurvesView::paintEvent(QPaintEvent *event)
     pen.setWidthF(ptSizeCurve);
     painter.setPen(pen);
 
-    // Draw curves
-    if ( nCurves == 2 ) {
-        QString plotPresentation = _bookModel()->getDataString(rootIndex(),
-                                                     "PlotPresentation","Plot");
-        if ( plotPresentation.isEmpty() ) {
-            plotPresentation = _bookModel()->getDataString(QModelIndex(),
-                                                           "Presentation");
-        }
-
-        // Plot background
-        QModelIndex pageIdx = rootIndex().parent().parent();
-        QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
-        painter.fillRect(viewport()->rect(),bg);
+    // Plot background
+    QModelIndex pageIdx = rootIndex().parent().parent();
+    QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
+    painter.fillRect(viewport()->rect(),bg);
 
-        _paintGrid(painter,rootIndex());
+    _paintGrid(painter,rootIndex());
 
+    // Draw curves
+    QString plotPresentation = _bookModel()->plotPresentation(rootIndex());
+    if ( plotPresentation.isEmpty() ) {
+        plotPresentation = _bookModel()->getDataString(QModelIndex(),
+                                                       "Presentation");
+    }
+    if ( plotPresentation == "statistics" ) {
+        if ( nCurves > 0 ) {
+            _paintStatsplot(T,painter,rootIndex());
+        }
+    } else if ( nCurves == 2 ) {
         if ( plotPresentation == "compare" ) {
             _paintCoplot(T,painter,pen);
         } else if ( plotPresentation == "error" ) {
@@ -451,14 +460,22 @@ void CurvesView::_paintCoplot(const QTransform &T,QPainter &painter,QPen &pen)
 {
     Q_UNUSED(pen);
 
-    if ( !_pixmap ) return;
+    if ( _liveImage.isNull() ) return;
 
     painter.save();
 
-    // Draw pixmap of all curves
+    // Draw image of all curves.  If the image is from before the last
+    // zoom/pan (a newer one is rendering), stretch it to where its math
+    // rect is now.
     QTransform I;
     painter.setTransform(I);
-    painter.drawPixmap(viewport()->rect(),*_pixmap);
+    QRectF S(QPointF(0,0),QSizeF(_liveImage.size()));
+    if ( _liveImageT == T ) {
+        painter.drawImage(S,_liveImage);
+    } else {
+        QRectF M = _liveImageT.inverted().mapRect(S);
+        painter.drawImage(T.mapRect(M),_liveImage,S);
+    }
 
     // If curve is selected
     QModelIndex gpidx = currentIndex().parent().parent();
@@ -485,197 +502,113 @@ void CurvesView::_paintCurve(const QModelIndex& curveIdx,
                              const QTransform& T,
                              QPainter& painter, bool isHighlight)
 {
-    painter.save();
-    QPen origPen = painter.pen();
+    if ( _bookModel()->getCurveModel(curveIdx) ) {
+        CurvesRenderer::paintCurve(_curveRenderItem(curveIdx,T,isHighlight,
+                                                    viewport()->rect()),
+                                   painter);
+    }
+}
 
-    CurveModel* curveModel = _bookModel()->getCurveModel(curveIdx);
+// Snapshot of what _paintCurve() needs from the model, so that curves can
+// also be painted off the GUI thread.  Decimated points cover the pixel
+// columns of V.
+CurveRenderItem CurvesView::_curveRenderItem(const QModelIndex& curveIdx,
+                                             const QTransform& T,
+                                             bool isHighlight,
+                                             const QRect& V)
+{
+    CurveRenderItem item;
 
-    if ( curveModel ) {
+    CurveProps props = _bookModel()->curveProps(curveIdx);
 
-        // Line color
-        QPen pen;
-        pen.setWidth(0);
-        QColor color(_bookModel()->getDataString(curveIdx,
-                                                 "CurveColor","Curve"));
-        if ( isHighlight ) {
-            QModelIndex pageIdx = curveIdx.parent().parent().parent().parent();
-            QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
-            if ( bg.lightness() < 128 ) {
-                color = color.lighter(120);
-            } else {
-                color = color.darker(200);
-            }
+    // Line color
+    QColor color(props.color);
+    if ( isHighlight ) {
+        QModelIndex pageIdx = curveIdx.parent().parent().parent().parent();
+        QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
+        if ( bg.lightness() < 128 ) {
+            color = color.lighter(120);
+        } else {
+            color = color.darker(200);
         }
-        pen.setColor(color);
+    }
+    item.color = color;
 
-        // Line style pattern
-        QString linestyle =  _bookModel()->getDataString(curveIdx,
-                                                      "CurveLineStyle","Curve");
-        QVector<qreal> pattern = _bookModel()->getLineStylePattern(linestyle);
-        pen.setDashPattern(pattern);
+    // Line style pattern
+    item.pattern = _bookModel()->getLineStylePattern(props.lineStyle);
 
-        // Set pen
-        painter.setPen(pen);
+    // Get painter path
+    QPainterPath* path = _bookModel()->getPainterPath(curveIdx);
+    item.path = *path;
 
-        // Get painter path
-        QPainterPath* path = _bookModel()->getPainterPath(curveIdx);
-
-        // Get plot scale
-        QModelIndex plotIdx = curveIdx.parent().parent();
-        QString plotXScale = _bookModel()->getDataString(plotIdx,
-                                                         "PlotXScale","Plot");
-        QString plotYScale = _bookModel()->getDataString(plotIdx,
-                                                         "PlotYScale","Plot");
+    // Get plot scale
+    QModelIndex plotIdx = curveIdx.parent().parent();
+    QString plotXScale = _bookModel()->getDataString(plotIdx,
+                                                     "PlotXScale","Plot");
+    QString plotYScale = _bookModel()->getDataString(plotIdx,
+                                                     "PlotYScale","Plot");
 
-        // Scale transform (e.g. for unit axis scaling)
-        // If logscale, scale/bias done in _createPainterPath
-        double xs = 1.0;
-        double ys = 1.0;
-        double xb = 0.0;
-        double yb = 0.0;
-        if ( plotXScale == "linear" ) {
-            xs = _bookModel()->xScale(curveIdx);
-            xb = _bookModel()->xBias(curveIdx);
-        }
-        if ( plotYScale == "linear" ) {
-            ys = _bookModel()->yScale(curveIdx);
-            yb = _bookModel()->yBias(curveIdx);
-        }
-        QTransform Tscaled(T);
-        Tscaled = Tscaled.scale(xs,ys);
-        Tscaled = Tscaled.translate(xb/xs,yb/ys);
-        painter.setTransform(Tscaled);
-
-        // Draw "Flatline=#" label if curve is flat (constant)
-        QRectF cbox = path->boundingRect();
-        if ( cbox.height() == 0.0 && path->elementCount() > 0 ) {
-            double y = cbox.y()*ys+yb;
-            if (plotYScale=="log") {
-                y = pow(10,y) ;
-            }
-            QString yString = QString("Flatline=%1").arg(y);
-            QRectF tbox = Tscaled.mapRect(cbox);
-            QTransform I;
-            painter.setTransform(I);
-            double top = tbox.y()-fontMetrics().ascent();
-            if ( top >= 0 ) {
-                // Draw flatline label over curve
-                painter.drawText(tbox.topLeft()-QPointF(0,5),yString);
-            } else {
-                // Draw flatline label under curve since it would drawn off page
-                painter.drawText(tbox.topLeft()+
-                                 QPointF(0,fontMetrics().ascent())
-                                 +QPointF(0,5),yString);
-            }
-            painter.setTransform(Tscaled);
-        } else if ( path->elementCount() == 0 ) {
-            // Empty plot
-            QTransform I;
-            painter.setTransform(I);
-            QString lbl("Empty");
-            QRect bb = fontMetrics().boundingRect(lbl);
-            QRect R = viewport()->rect();
-            painter.drawText(R.center()+QPointF(-bb.width()/2,0),lbl);
-            painter.setTransform(Tscaled);
+    // Scale transform (e.g. for unit axis scaling)
+    // If logscale, scale/bias done in _createPainterPath
+    double xs = 1.0;
+    double ys = 1.0;
+    double xb = 0.0;
+    double yb = 0.0;
+    if ( plotXScale == "linear" ) {
+        xs = props.xs;
+        xb = props.xb;
+    }
+    if ( plotYScale == "linear" ) {
+        ys = props.ys;
+        yb = props.yb;
+    }
+    QTransform Tscaled(T);
+    Tscaled = Tscaled.scale(xs,ys);
+    Tscaled = Tscaled.translate(xb/xs,yb/ys);
+    item.T = Tscaled;
+
+    // "Flatline=#" label if curve is flat (constant)
+    CurveLod* lod = _bookModel()->getCurveLod(curveIdx);
+    QRectF cbox = lod->boundingRect();
+    if ( cbox.height() == 0.0 && lod->count() > 0 ) {
+        double y = cbox.y()*ys+yb;
+        if (plotYScale=="log") {
+            y = pow(10,y) ;
         }
-
-        // Line style
-        QString lineStyle = _bookModel()->getDataString(curveIdx,
-                                                      "CurveLineStyle","Curve");
-        lineStyle = lineStyle.toLower();
-
-        // Draw curve!
-        if ( lineStyle == "thick_line" || lineStyle == "x_thick_line" ) {
-            // The transform cannot be used when drawing thick lines
-            QTransform I;
-            painter.setTransform(I);
-            double w = pen.widthF();
-            if ( lineStyle == "thick_line" ) {
-                pen.setWidth(3.0);
-            } else if ( lineStyle == "x_thick_line" ) {
-                pen.setWidthF(5.0);
-            } else {
-                fprintf(stderr, "koviz [bad scoobs]: "
-                                "CurvesView::_paintCurve: bad linestyle\n");
-                exit(-1);
-            }
-            painter.setPen(pen);
-            QPointF pLast;
-            for ( int i = 0; i < path->elementCount(); ++i ) {
-                QPainterPath::Element el = path->elementAt(i);
-                QPointF p(el.x,el.y);
-                p = Tscaled.map(p);
-                if  ( i > 0 ) {
-                    painter.drawLine(pLast,p);
-                }
-                pLast = p;
-            }
-            pen.setWidthF(w);
-            painter.setPen(pen);
-            painter.setTransform(Tscaled);
-        } else if ( lineStyle == "scatter" ) {
-            QTransform I;
-            painter.setTransform(I);
-            double w = pen.widthF();
-            pen.setWidthF(1.5);
-            painter.setPen(pen);
-            QBrush origBrush = painter.brush();
-            QBrush brush(Qt::SolidPattern);
-            brush.setColor(color);
-            painter.setBrush(brush);
-            double r = pen.widthF();
-            for ( int i = 0; i < path->elementCount(); ++i ) {
-                QPainterPath::Element el = path->elementAt(i);
-                QPointF p(el.x,el.y);
-                p = Tscaled.map(p);
-                painter.drawEllipse(p,r,r);
-            }
-            pen.setWidthF(w);
-            painter.setPen(pen);
-            painter.setBrush(origBrush);
-            painter.setTransform(Tscaled);
+        item.label = QString("Flatline=%1").arg(y);
+        QRectF tbox = Tscaled.mapRect(cbox);
+        double top = tbox.y()-fontMetrics().ascent();
+        if ( top >= 0 ) {
+            // Draw flatline label over curve
+            item.labelPos = tbox.topLeft()-QPointF(0,5);
         } else {
-            painter.drawPath(*path);
+            // Draw flatline label under curve since it would drawn off page
+            item.labelPos = tbox.topLeft()+
+                            QPointF(0,fontMetrics().ascent())+QPointF(0,5);
         }
+    } else if ( lod->count() == 0 ) {
+        // Empty plot
+        item.label = "Empty";
+        QRect bb = fontMetrics().boundingRect(item.label);
+        QRect R = viewport()->rect();
+        item.labelPos = R.center()+QPointF(-bb.width()/2,0);
+    }
 
-        // Draw symbols on curve (if there are any)
-        QString symbolStyle = _bookModel()->getDataString(curveIdx,
-                                               "CurveSymbolStyle", "Curve");
-        symbolStyle = symbolStyle.toLower();
-        if ( !symbolStyle.isEmpty() && symbolStyle != "none" ) {
-            pattern.clear();
-            pen.setDashPattern(pattern); // plain lines for drawing symbols
-            QTransform I;
-            painter.setTransform(I);
-            double w = pen.widthF();
-            pen.setWidthF(0.0);
-            painter.setPen(pen);
-            QPointF pLast;
-            for ( int i = 0; i < path->elementCount(); ++i ) {
-                QPainterPath::Element el = path->elementAt(i);
-                QPointF p(el.x,el.y);
-                p = Tscaled.map(p);
-                if ( i > 0 ) {
-                    double r = 32.0;
-                    double x = pLast.x()-r/2.0;
-                    double y = pLast.y()-r/2.0;
-                    QRectF R(x,y,r,r);
-                    if ( R.contains(p) ) {
-                        continue;
-                    }
-                }
-
-                __paintSymbol(p,symbolStyle,painter);
+    // Line style
+    item.lineStyle = props.lineStyle.toLower();
 
-                pLast = p;
-            }
-            pen.setWidthF(w);
-            painter.setPen(pen);
-            painter.setTransform(Tscaled);
-        }
+    // For monotonic x (e.g. time), decimate the visible part of the
+    // path down to about two vertices per pixel column
+    item.isMonotonic = lod->isMonotonic();
+    if ( item.isMonotonic && item.lineStyle != "scatter" ) {
+        QRectF W = Tscaled.inverted().mapRect(QRectF(V));
+        item.pts = lod->polyline(W.left(),W.right(),V.width());
     }
-    painter.setPen(origPen);
-    painter.restore();
+
+    // Symbols on curve
+    item.symbolStyle = props.symbolStyle.toLower();
+
+    return item;
 }
 
 void CurvesView::_paintMarkers(QPainter &painter)
@@ -699,8 +632,7 @@ void CurvesView::_paintMarkers(QPainter &painter)
 
     TimeAndIndex* liveMarker = 0;
     QList<TimeAndIndex*> markers;
-    QString pres = _bookModel()->getDataString(rootIndex(),
-                                               "PlotPresentation","Plot");
+    QString pres = _bookModel()->plotPresentation(rootIndex());
     QString tag = model()->data(currentIndex()).toString();
     QModelIndex liveIdx = _bookModel()->getDataIndex(QModelIndex(),
                                                      "LiveCoordTime");
@@ -791,9 +723,6 @@ void CurvesView::_paintMarkers(QPainter &painter)
             path = _bookModel()->getCurvesErrorPath(curvesIdx);
         }
         if ( path->elementCount() == 0 ) {
-            if ( tag == "Plot" ) {
-                delete path; // error path created on the fly!
-            }
             continue;
         }
 
@@ -809,19 +738,9 @@ void CurvesView::_paintMarkers(QPainter &painter)
             }
         }
 
-        // Get element index (i) for time (t)
+        // Get element index (i) for time (t), first of any duplicates
         int high = path->elementCount()-1;
-        int i = _idxAtTimeBinarySearch(path,0,high,t);
-
-        /* There may be duplicate timestamps in sequence - go to first */
-        double elementTime = path->elementAt(i).x;
-        while ( i > 0 ) {
-            if ( path->elementAt(i-1).x == elementTime ) {
-                --i;
-            } else {
-                break;
-            }
-        }
+        int i = CurveTimeIndex::pathIndexAtTime(path,t);
 
         // If timestamps identical, it may be necessary to add LiveCoordTimeidx
         int ii = marker->timeIdx();
@@ -831,8 +750,8 @@ void CurvesView::_paintMarkers(QPainter &painter)
             // If x is not time (e.g. ball xy orbit), i is calculated from
             // the curve model instead of the path
             QModelIndex curveIdx = marker->modelIdx();
-            CurveModel* curveModel = _bookModel()->getCurveModel(curveIdx);
-            curveModel->map();
+            CurveTimeIndex* timeIndex =
+                                  _bookModel()->getCurveTimeIndex(curveIdx);
             QModelIndex plotIdx = marker->modelIdx().parent().parent();
             if ( !_bookModel()->isXTime(plotIdx) ) {
                 // e.g. ball xy curve where x is position[0]
@@ -848,30 +767,19 @@ void CurvesView::_paintMarkers(QPainter &painter)
                 }
                 double start = _bookModel()->getDataDouble(QModelIndex(),
                                                            "StartTime");
-                i = curveModel->indexAtTime(marker->time());
-                /* There may be duplicate timestamps in sequence - goto first */
-                ModelIterator* it = curveModel->begin();
-                double iTime = it->at(i)->t();
-                while ( i > 0 ) {
-                    if ( it->at(i-1)->t() == iTime ) {
-                        --i;
-                    } else {
-                        break;
-                    }
-                }
+                // First of possible duplicate timestamps
+                i = timeIndex->indexAtTime(marker->time());
                 i = i + ii;
-                int j = curveModel->indexAtTime(start);
+                int j = timeIndex->indexAtTime(start);
                 i = i - j;
                 if ( i < 0 ) {
                     // This can happen when liveCoord is unset (0.0) initially
-                    curveModel->unmap();
                     continue;
                 }
                 if ( i > high ) {
                     i = high;
                 }
             }
-            curveModel->unmap();
         }
 
         // Element/coord at live time
@@ -945,10 +853,6 @@ void CurvesView::_paintMarkers(QPainter &painter)
         } else if ( marker->modelIdx() == currentIndex() ) {
             arrow.paintMeCenter(painter,T,viewport()->rect(),fg,bg);
         }
-
-        if ( tag == "Plot" ) {
-            delete path; // error path created on the fly, so it must be freed
-        }
     }
 
     painter.restore();
@@ -958,28 +862,6 @@ void CurvesView::_paintMarkers(QPainter &painter)
     }
 }
 
-int CurvesView::_idxAtTimeBinarySearch(QPainterPath* path,
-                                       int low, int high, double time)
-{
-        if (high <= 0 ) {
-                return 0;
-        }
-        if (low >= high) {
-                return ( path->elementAt(high).x > time ) ? high-1 : high;
-        } else {
-                int mid = (low + high)/2;
-                if (time == path->elementAt(mid).x ) {
-                        return mid;
-                } else if ( time < path->elementAt(mid).x ) {
-                        return _idxAtTimeBinarySearch(path,
-                                                      low, mid-1, time);
-                } else {
-                        return _idxAtTimeBinarySearch(path,
-                                                      mid+1, high, time);
-                }
-        }
-}
-
 void CurvesView::_keyPressPeriod()
 {
     // If curve is selected
@@ -1036,9 +918,14 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
 
         QModelIndex curveIdx = currentIndex();
         CurveModel* curveModel = _bookModel()->getCurveModel(curveIdx);
-        curveModel->map();
+        CurveTimeIndex* timeIndex = _bookModel()->getCurveTimeIndex(curveIdx);
+        int rc = timeIndex->count();
+        if ( rc == 0 ) {
+            return;
+        }
 
         // Calculate liveCoord based on model liveCoordTime
+        // (i is first of possible duplicate timestamps)
         double xs = _bookModel()->xScale(curveIdx);
         double xb = _bookModel()->xBias(curveIdx);
         QModelIndex liveIdx = _bookModel()->getDataIndex(QModelIndex(),
@@ -1048,24 +935,13 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
         int i = 0;
         bool isXTime = (curveModel->x()->name() == curveModel->t()->name());
         if ( isXTime ) {
-            i = curveModel->indexAtTime((liveTime-xb)/xs);
+            i = timeIndex->indexAtTime((liveTime-xb)/xs);
         } else {
             // e.g. ball xy curve where x is position[0]
-            i = curveModel->indexAtTime(liveTime);
+            i = timeIndex->indexAtTime(liveTime);
         }
 
         double timeStamp = liveTime;
-        ModelIterator* it = curveModel->begin();
-
-        /* Timestamps may be identical, set i to first duplicate */
-        double itTime = it->at(i)->t();
-        while ( i > 0 ) {
-            if ( it->at(i-1)->t() == itTime ) {
-                --i;
-            } else {
-                break;
-            }
-        }
 
         /* Get current index for possible duplicate timestamps (ii) */
         QModelIndex idx = _bookModel()->getDataIndex(QModelIndex(),
@@ -1075,11 +951,11 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
 
         if ( arrow == Qt::LeftArrow ) {
             while ( i+ii > 0 ) {
-                it = it->at(i+ii-1);
+                int k = i+ii-1;
                 if ( isXTime ) {
-                    timeStamp = it->x()*xs+xb;
+                    timeStamp = timeIndex->time(k)*xs+xb;
                 } else {
-                    timeStamp = it->t();
+                    timeStamp = timeIndex->time(k);
                 }
                 double dt = qAbs(timeStamp-liveTime);
                 if ( dt == 0 ) {
@@ -1088,18 +964,8 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
                     _bookModel()->setData(idx,--ii);
                     break;
                 } else {
-                    int jj = 0;  // Last index of possible duplicate timestamps
-                    int j = i-1;
-                    double jTime = it->at(j+ii)->t();
-                    while ( j+ii-1 >= 0 ) {
-                        if ( it->at(j+ii-1)->t() == jTime ) {
-                            ++jj;
-                            --j;
-                        } else {
-                            break;
-                        }
-                    }
-                    _bookModel()->setData(idx,jj);
+                    // Land on last of possible duplicate timestamps
+                    _bookModel()->setData(idx,k-timeIndex->runBegin(k));
                 }
                 if ( dt > 1.0e-16 ) {
                     break;
@@ -1108,12 +974,11 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
             }
 
         } else if ( arrow == Qt::RightArrow ) {
-            it = it->at(i+1+ii);
-            while ( !it->isDone() ) {
+            for ( int k = i+1+ii; k < rc; ++k ) {
                 if ( isXTime ) {
-                    timeStamp = it->x()*xs+xb;
+                    timeStamp = timeIndex->time(k)*xs+xb;
                 } else {
-                    timeStamp = it->t();
+                    timeStamp = timeIndex->time(k);
                 }
                 double dt = qAbs(timeStamp-liveTime);
                 if ( dt == 0 ) {
@@ -1129,10 +994,8 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
                 if ( qAbs(timeStamp-liveTime) > 1.0e-16  ) {
                     break;
                 }
-                it->next();
             }
         }
-        delete it;
 
         double start = _bookModel()->getDataDouble(QModelIndex(), "StartTime");
         double stop = _bookModel()->getDataDouble(QModelIndex(), "StopTime");
@@ -1142,8 +1005,6 @@ void CurvesView::_keyPressArrow(const Qt::ArrowType& arrow)
             timeStamp = stop;
         }
         _bookModel()->setData(liveIdx,timeStamp);
-
-        curveModel->unmap();
     }
 }
 
@@ -1156,7 +1017,7 @@ void CurvesView::_paintErrorplot(const QTransform &T,
     QModelIndex curvesIdx = _bookModel()->getIndex(plotIdx,"Curves","Plot");
     QPainterPath* errorPath = _bookModel()->getCurvesErrorPath(curvesIdx);
 
-    QRectF ebox = errorPath->boundingRect();
+    QRectF ebox = _bookModel()->getCurvesErrorBBox(curvesIdx);
     QPen ePen(pen);
     if ( ebox.height() == 0.0 && ebox.y() == 0.0 ) {
         // Color green if error plot is flatline zero
@@ -1189,12 +1050,36 @@ void CurvesView::_paintErrorplot(const QTransform &T,
     painter.setTransform(T);
     painter.drawPath(*errorPath);
 
-    delete errorPath;
-
     painter.setPen(pen);
     painter.restore();
 }
 
+// Draws the statistics bands of the plot's curves instead of the curves
+void CurvesView::_paintStatsplot(const QTransform &T, QPainter &painter,
+                                 const QModelIndex &plotIdx)
+{
+    painter.save();
+
+    QModelIndex curvesIdx = _bookModel()->getIndex(plotIdx,"Curves","Plot");
+
+    // Bands are drawn in device pixels so dash patterns don't scale
+    QTransform I;
+    painter.setTransform(I);
+    for ( int b = 0; b < CurveStats::NumBands; ++b ) {
+        CurveStats::Band band = (CurveStats::Band) b;
+        QString style = _bookModel()->statsBandLineStyle(band);
+        QPen pen;
+        pen.setWidth(( style == "thick_line" ) ? 3 : 0);
+        pen.setColor(_bookModel()->statsBandColor(band));
+        pen.setDashPattern(_bookModel()->getLineStylePattern(style));
+        painter.setPen(pen);
+        QPainterPath* path = _bookModel()->getCurvesStatsPath(curvesIdx,band);
+        painter.drawPath(T.map(*path));
+    }
+
+    painter.restore();
+}
+
 QSize CurvesView::minimumSizeHint() const
 {
     QSize s;
@@ -1221,10 +1106,7 @@ void CurvesView::dataChanged(const QModelIndex &topLeft,
         QRectF M = model()->data(topLeft).toRectF();
 
         if ( M.size().width() > 0 && M.size().height() != 0 && _lastM != M ) {
-            if ( _pixmap ) {
-                delete _pixmap;
-            }
-            _pixmap = _createLivePixmap();
+            _scheduleRender(M.size() == _lastM.size());
         }
 
         _lastM = M;  // Saved so that pixmap is not recreated if M unchanged
@@ -1274,31 +1156,21 @@ void CurvesView::dataChanged(const QModelIndex &topLeft,
         }
     } else if ( topLeft.parent().parent().parent() == rootIndex() ) {
         if ( tag == "CurveXBias" ) {
-            if ( _pixmap ) {
-                delete _pixmap;
-            }
-            _pixmap = _createLivePixmap();
+            _scheduleRender();
         } else if ( tag == "CurveColor") {
-            if ( _pixmap ) {
-                delete _pixmap;
-            }
-            _pixmap = _createLivePixmap();
+            _scheduleRender();
         } else if ( tag == "CurveData") {
-            if ( _pixmap ) {
-                delete _pixmap;
-            }
-            _pixmap = _createLivePixmap();
+            _scheduleRender();
         }
     } else if ( topLeft.parent() == rootIndex() ) {
         if ( tag == "PlotXScale" || tag == "PlotYScale" ) {
-            if ( _pixmap ) {
-                delete _pixmap;
-            }
-            _pixmap = _createLivePixmap();
+            _scheduleRender();
             QModelIndex curvesIdx = _bookModel()->getIndex(rootIndex(),
                                                            "Curves","Plot");
             QRectF bbox = _bookModel()->calcCurvesBBox(curvesIdx);
             _bookModel()->setPlotMathRect(bbox,rootIndex());
+        } else if ( tag == "PlotPresentation" ) {
+            _scheduleRender();
         }
     }
 
@@ -1306,37 +1178,125 @@ void CurvesView::dataChanged(const QModelIndex &topLeft,
     update();
 }
 
-QPixmap* CurvesView::_createLivePixmap()
+// Starts rendering the curves on the renderer's thread, replacing any
+// render still in progress.  _liveImage is set when it's done.
+//
+// For a pan (math rect moved, not resized) the current image is reused,
+// shifted by the pan, and only the newly exposed strip is rendered.
+// Curves are still decimated over the whole viewport so the strip's
+// buckets line up with the shifted image's.  Symbol decluttering can
+// still differ at the seam, so the full image is re-rendered once
+// panning stops.
+void CurvesView::_renderLiveImage(bool isPan)
 {
     if ( viewport()->rect().size().width() == 0 ||
-         viewport()->rect().size().height() == 0 ) {
-        return 0;
-    }
-    bool isCurves  = _bookModel()->isChildIndex(rootIndex(),"Plot","Curves");
-    if ( !isCurves ) {
-        return 0;
+         viewport()->rect().size().height() == 0 ||
+         !_bookModel()->isChildIndex(rootIndex(),"Plot","Curves") ) {
+        _renderer->cancel();
+        _liveImage = QImage();
+        return;
     }
 
-    QPixmap* livePixmap = new QPixmap(viewport()->rect().size());
-
-    QPainter painter(livePixmap);
-    painter.setRenderHint(QPainter::Antialiasing);
-
-    QModelIndex pageIdx = rootIndex().parent().parent();
-    QColor bg = _bookModel()->pageBackgroundColor(pageIdx);
-    painter.fillRect(viewport()->rect(),bg);
+    // Statistics plots draw bands in place of the curves
+    QString plotPresentation = _bookModel()->plotPresentation(rootIndex());
+    if ( plotPresentation.isEmpty() ) {
+        plotPresentation = _bookModel()->getDataString(QModelIndex(),
+                                                       "Presentation");
+    }
+    if ( plotPresentation == "statistics" ) {
+        _renderer->cancel();
+        _liveImage = QImage();
+        return;
+    }
 
-    _paintGrid(painter, rootIndex());
+    CurvesRenderJob job;
+    job.size = viewport()->rect().size();
+    job.T = _coordToPixelTransform();
+    job.font = font();
+
+    // Pan is a whole pixel shift of the same scale and size
+    QRect V = viewport()->rect();
+    if ( isPan && !_liveImage.isNull() && _liveImage.size() == job.size ) {
+        const QTransform& A = _liveImageT;
+        const QTransform& B = job.T;
+        double dx = B.dx()-A.dx();
+        double dy = B.dy()-A.dy();
+        QPoint d(qRound(dx),qRound(dy));
+        isPan = ( qFuzzyCompare(A.m11(),B.m11()) && A.m12() == B.m12() &&
+                  A.m21() == B.m21() && qFuzzyCompare(A.m22(),B.m22()) &&
+                  qAbs(dx-d.x()) < 0.01 && qAbs(dy-d.y()) < 0.01 &&
+                  qAbs(d.x()) < V.width() && qAbs(d.y()) < V.height() );
+        if ( isPan ) {
+            job.base = _liveImage;
+            job.baseOffset = d;
+            job.exposed = QRegion(V).subtracted(QRegion(V.translated(d)));
+        }
+    } else {
+        isPan = false;
+    }
 
-    QTransform T = _coordToPixelTransform();
     QModelIndex curvesIdx = _bookModel()->getIndex(rootIndex(),"Curves","Plot");
     int rc = model()->rowCount(curvesIdx);
     for ( int i = 0; i < rc; ++i ) {
         QModelIndex curveIdx = model()->index(i,0,curvesIdx);
-        _paintCurve(curveIdx,T,painter,false);
+        if ( _bookModel()->getCurveModel(curveIdx) ) {
+            CurveRenderItem item = _curveRenderItem(curveIdx,job.T,false,V);
+            if ( isPan && item.path.elementCount() == 0 ) {
+                // The "Empty" label is centered, so it can't be shifted
+                _renderLiveImage(false);
+                return;
+            }
+            job.items << item;
+        }
+    }
+
+    _renderer->render(job);
+
+    if ( isPan ) {
+        _panSettleTimer->start();
+    } else {
+        _panSettleTimer->stop();
+    }
+}
+
+// Renders once control returns to the event loop.  A zoom or pan is
+// propagated to the other x-time plots through the model, so one gesture
+// changes many PlotMathRects and curve settings in a burst.  Each plot then
+// snapshots and queues its curves once, after the burst.
+void CurvesView::_scheduleRender(bool isPan)
+{
+    if ( _isRenderPending ) {
+        _isPendingPan = _isPendingPan && isPan;
+        return;
+    }
+    _isRenderPending = true;
+    _isPendingPan = isPan;
+    QTimer::singleShot(0,this,SLOT(_renderScheduled()));
+}
+
+void CurvesView::_renderScheduled()
+{
+    if ( !_isRenderPending ) {
+        return;
+    }
+    _isRenderPending = false;
+    _renderLiveImage(_isPendingPan);
+}
+
+// Panning stopped, replace the stitched image with a full render
+void CurvesView::_panSettled()
+{
+    if ( _isRenderPending ) {
+        return;
     }
+    _renderLiveImage(false);
+}
 
-    return livePixmap;
+void CurvesView::_liveImageRendered(const QImage &image, const QTransform &T)
+{
+    _liveImage = image;
+    _liveImageT = T;
+    viewport()->update();
 }
 
 QString CurvesView::_format(double d)
@@ -1438,8 +1398,7 @@ void CurvesView::mouseReleaseEvent(QMouseEvent *event)
         double x1 = event->pos().x();
         double y1 = event->pos().y();
         double d = qSqrt((x1-x0)*(x1-x0)+(y1-y0)*(y1-y0));
-        QString presentation = _bookModel()->getDataString(rootIndex(),
-                                                   "PlotPresentation","Plot");
+        QString presentation = _bookModel()->plotPresentation(rootIndex());
         if ( d < 10 && (presentation == "compare" || presentation.isEmpty()) ) {
             // d < 10, to hopefully catch click and not a drag
             QModelIndex curveIdx = _chooseCurveNearMousePoint(event->pos());
@@ -1496,31 +1455,11 @@ QModelIndex CurvesView::_chooseCurveNearMousePoint(const QPoint &pt)
 {
     QModelIndex idx;
 
-    QImage img(viewport()->rect().size(),QImage::Format_Mono);
-
-    QPainter painter(&img);
-    QPen penBlack(img.colorTable().at(0));
-    penBlack.setWidth(0);
-    painter.setPen(penBlack);
-
-    QTransform T = _coordToPixelTransform();  // _paintCurve sets painter tform
+    QTransform T = _coordToPixelTransform();
 
     int s = 12; // side length of small square around mouse click
     QRectF R(pt.x()-s/2,pt.y()-s/2,s,s);
 
-    // Speed up test by drawing clipped to small square
-    painter.setClipRect(R);
-
-    QRectF W = viewport()->rect();
-    QRectF M = _mathRect();
-    double a = M.width()/W.width();
-    double b = M.height()/W.height();
-    double c = M.x() - a*W.x();
-    double d = M.y() - b*W.y();
-    QTransform U( a,    0,
-                  0,    b, /*+*/ c,    d);
-    M = U.mapRect(R);
-
     QString plotXScale = _bookModel()->getDataString(rootIndex(),
                                                      "PlotXScale","Plot");
     QString plotYScale = _bookModel()->getDataString(rootIndex(),
@@ -1530,13 +1469,8 @@ QModelIndex CurvesView::_chooseCurveNearMousePoint(const QPoint &pt)
     int rc = model()->rowCount(curvesIdx);
     for ( int i = rc-1; i >= 0; --i ) {  // check curves from top to bottom
 
-        // fill image with white (see help for QImage::fill(int))
-        img.fill(1);
-
-        // Get underlying path that goes with curve
         QModelIndex curveIdx = model()->index(i,0,curvesIdx);
-        QPainterPath* path = _bookModel()->getPainterPath(curveIdx);
-        if ( !path ) {
+        if ( !_bookModel()->getCurveModel(curveIdx) ) {
             continue;
         }
 
@@ -1556,47 +1490,13 @@ QModelIndex CurvesView::_chooseCurveNearMousePoint(const QPoint &pt)
         QTransform Tscaled(T);
         Tscaled = Tscaled.scale(xs,ys);
         Tscaled = Tscaled.translate(xb/xs,yb/ys);
-        painter.setTransform(Tscaled);
-
-        // Ignore paths whose bounding box does not intersect
-        // math click rect. This speeds up a special case of
-        // selecting a spike which falls outside most other curves
-        if ( xs == 1.0 && ys == 1.0 && xb == 0 && yb == 0 ) {
-            // TODO: Lazily checking for xs==ys==1.0 because of scaling issues
-            if ( !path->intersects(M) ) {
-                continue;
-            }
-        }
-
-        // Draw curve onto monochrome image (clipped to small square)
-        painter.drawPath(*path);
 
-        // Check, pixel by pixel, to see if the curve
-        // is in small rectangle around mouse click
-        bool isFound = false;
-        for ( int x = pt.x()-s/2; x < pt.x()+s/2; ++x ) {
-            if ( x < 0 || x >= img.width() ) {
-                continue;
-            }
-            for ( int y = pt.y()-s/2; y < pt.y()+s/2; ++y ) {
-                if ( y < 0 || y >= img.height() ) {
-                    continue;
-                }
-                QRgb pix = img.pixel(x,y);
-                if ( qRed(pix) == 0 ) {
-                    // qRed(pix) is arbitrary. Pen is black and has no red.
-                    isFound = true;
-                    break;
-                }
-            }
-            if ( isFound ) break;
-        }
-        if ( isFound ) {
+        // Look up small square around mouse click in path coords
+        QRectF M = Tscaled.inverted().mapRect(R);
+        if ( _bookModel()->getCurveHitIndex(curveIdx)->intersects(M) ) {
             idx = curveIdx;  // choose first curve inside rect and bail
             break;
         }
-
-
     }
 
     return idx;
@@ -1606,67 +1506,16 @@ bool CurvesView::_isErrorCurveNearMousePoint(const QPoint &pt)
 {
     bool isNear = false;
 
-    QImage img(viewport()->rect().size(),QImage::Format_Mono);
-
-    QPainter painter(&img);
-    QPen penBlack(img.colorTable().at(0));
-    penBlack.setWidth(0);
-    painter.setPen(penBlack);
-
-    QTransform T = _coordToPixelTransform();  // _paintCurve sets painter tform
+    QTransform T = _coordToPixelTransform();
 
     int s = 12; // side length of small square around mouse click
     QRectF R(pt.x()-s/2,pt.y()-s/2,s,s);
-
-    // Speed up test by drawing clipped to small square
-    painter.setClipRect(R);
-
-    QRectF W = viewport()->rect();
-    QRectF M = _mathRect();
-    double a = M.width()/W.width();
-    double b = M.height()/W.height();
-    double c = M.x() - a*W.x();
-    double d = M.y() - b*W.y();
-    QTransform U( a,    0,
-                  0,    b, /*+*/ c,    d);
-    M = U.mapRect(R);
+    QRectF M = T.inverted().mapRect(R);
 
     QModelIndex curvesIdx = _bookModel()->getIndex(rootIndex(),"Curves","Plot");
     QPainterPath* path = _bookModel()->getCurvesErrorPath(curvesIdx);
     if ( path ) {
-
-        // fill image with white (see help for QImage::fill(int))
-        img.fill(1);
-
-        painter.setTransform(T);
-
-        if ( path->intersects(M) ) {
-
-            // Draw curve onto monochrome image (clipped to small square)
-            painter.drawPath(*path);
-
-            // Check, pixel by pixel, to see if the curve
-            // is in small rectangle around mouse click
-            for ( int x = pt.x()-s/2; x < pt.x()+s/2; ++x ) {
-                if ( x < 0 || x >= img.width() ) {
-                    continue;
-                }
-                for ( int y = pt.y()-s/2; y < pt.y()+s/2; ++y ) {
-                    if ( y < 0 || y >= img.height() ) {
-                        continue;
-                    }
-                    QRgb pix = img.pixel(x,y);
-                    if ( qRed(pix) == 0 ) {
-                        // qRed(pix) is arbitrary. Pen is black and has no red.
-                        isNear = true;
-                        break;
-                    }
-                }
-                if ( isNear ) break;
-            }
-        }
-
-        delete path;
+        isNear = CurveHitIndex::intersects(*path,M);
     }
 
     return isNear;
@@ -1683,8 +1532,7 @@ void CurvesView::mouseMoveEvent(QMouseEvent *event)
     if ( event->buttons() == Qt::NoButton && currentIndex().isValid() ) {
 
         QString tag = model()->data(currentIndex()).toString();
-        QString presentation = _bookModel()->getDataString(rootIndex(),
-                                                   "PlotPresentation","Plot");
+        QString presentation = _bookModel()->plotPresentation(rootIndex());
 
         // If shift pressed while moving the mouse, do not update
         // the live coordinate.  This saves the live coord from
@@ -1769,8 +1617,8 @@ void CurvesView::mouseMoveEvent(QMouseEvent *event)
 
                     } else if ( rc >= 3 ) {
 
-                        int i =  _idxAtTimeBinarySearch(path,0,rc-1,
-                                                        (mPt.x()-xb)/xs);
+                        int i = CurveTimeIndex::pathIndexAtTime(path,
+                                                             (mPt.x()-xb)/xs);
                         QPainterPath::Element el = path->elementAt(i);
                         QPointF p(el.x*xs+xb,el.y*ys+yb);
 
@@ -1921,7 +1769,7 @@ void CurvesView::mouseMoveEvent(QMouseEvent *event)
                     if ( plotXScale == "log") {
                         time = log10(time);
                     }
-                    int i =  _idxAtTimeBinarySearch(path,0,rc-1,(time-xb)/xs);
+                    int i = CurveTimeIndex::pathIndexAtTime(path,(time-xb)/xs);
                     double iTime = path->elementAt(i).x;
                     int j = i;  // j is start index of identical timestamps
                     for ( int l = i; l >= 0; --l ) {
@@ -2084,7 +1932,7 @@ void CurvesView::mouseMoveEvent(QMouseEvent *event)
 
             } else if ( rc >= 3 ) {
 
-                int i =  _idxAtTimeBinarySearch(path,0,rc-1,mPt.x());
+                int i = CurveTimeIndex::pathIndexAtTime(path,mPt.x());
                 QPainterPath::Element el = path->elementAt(i);
                 QPointF p(el.x,el.y);
 
@@ -2308,10 +2156,7 @@ void CurvesView::currentChanged(const QModelIndex &current,
 
 void CurvesView::resizeEvent(QResizeEvent *event)
 {
-    if ( _pixmap ) {
-        delete _pixmap;
-    }
-    _pixmap = _createLivePixmap();
+    _scheduleRender();
 
     QAbstractItemView::resizeEvent(event);
 }
@@ -2322,12 +2167,21 @@ void CurvesView::_keyPressSpace()
 {
     QModelIndex curvesIdx = _bookModel()->getIndex(rootIndex(),"Curves","Plot");
     int rc = model()->rowCount(curvesIdx);
-    if ( rc != 2 ) return;
+    if ( rc < 2 ) return;
 
-    QString plotPresentation = _bookModel()->getDataString(rootIndex(),
-                                                   "PlotPresentation","Plot");
+    QString plotPresentation = _bookModel()->plotPresentation(rootIndex());
 
-    if ( plotPresentation == "error" || plotPresentation.isEmpty() ) {
+    if ( rc > 2 ) {
+        // Many curves (e.g. a Monte Carlo set) toggle with their statistics,
+        // which are only computed over time
+        if ( plotPresentation == "statistics" ||
+             !_bookModel()->isXTime(rootIndex()) ) {
+            plotPresentation = "compare";
+        } else {
+            plotPresentation = "statistics";
+        }
+    } else if ( plotPresentation == "error" || plotPresentation.isEmpty() ||
+                plotPresentation == "statistics" ) {
         plotPresentation = "compare";
     } else if ( plotPresentation == "compare" ) {
         plotPresentation = "error+compare";
@@ -2340,32 +2194,36 @@ void CurvesView::_keyPressSpace()
         exit(-1);
     }
 
-    // Make units the same (in the book model)
-    QModelIndex idx0 = model()->index(0,0,curvesIdx);
-    QModelIndex idx1 = model()->index(1,0,curvesIdx);
-    QString dpYUnit0 = _bookModel()->getDataString(idx0,"CurveYUnit","Curve");
-    QString dpYUnit1 = _bookModel()->getDataString(idx1,"CurveYUnit","Curve");
-    CurveModel* c0 = _bookModel()->getCurveModel(curvesIdx,0);
-    if ( c0->y()->unit() != dpYUnit0 ) {
-        if ( dpYUnit0.isEmpty() || dpYUnit0 == "--" ) {
-            QModelIndex unitIdx0 = _bookModel()->getDataIndex(idx0,
-                                                         "CurveYUnit", "Curve");
-            model()->setData(unitIdx0,c0->y()->unit());
-            dpYUnit0 = c0->y()->unit();
+    if ( rc == 2 ) {
+        // Make units the same (in the book model)
+        QModelIndex idx0 = model()->index(0,0,curvesIdx);
+        QModelIndex idx1 = model()->index(1,0,curvesIdx);
+        QString dpYUnit0 = _bookModel()->getDataString(idx0,
+                                                       "CurveYUnit","Curve");
+        QString dpYUnit1 = _bookModel()->getDataString(idx1,
+                                                       "CurveYUnit","Curve");
+        CurveModel* c0 = _bookModel()->getCurveModel(curvesIdx,0);
+        if ( c0->y()->unit() != dpYUnit0 ) {
+            if ( dpYUnit0.isEmpty() || dpYUnit0 == "--" ) {
+                QModelIndex unitIdx0 = _bookModel()->getDataIndex(idx0,
+                                                         "CurveYUnit","Curve");
+                model()->setData(unitIdx0,c0->y()->unit());
+                dpYUnit0 = c0->y()->unit();
+            }
         }
-    }
-    if ( dpYUnit0 != dpYUnit1 && !dpYUnit0.isEmpty() && !dpYUnit1.isEmpty() ) {
-        // Make dp units the same (if in same family)
-        QString u0(dpYUnit0);
-        QString u1(dpYUnit1);
-        if ( Unit::canConvert(u0,u1) ) {
-            QModelIndex unitIdx1 = _bookModel()->getDataIndex(idx1,
-                                                         "CurveYUnit", "Curve");
-            model()->setData(unitIdx1,dpYUnit0);
+        if ( dpYUnit0 != dpYUnit1 &&
+             !dpYUnit0.isEmpty() && !dpYUnit1.isEmpty() ) {
+            // Make dp units the same (if in same family)
+            QString u0(dpYUnit0);
+            QString u1(dpYUnit1);
+            if ( Unit::canConvert(u0,u1) ) {
+                QModelIndex unitIdx1 = _bookModel()->getDataIndex(idx1,
+                                                         "CurveYUnit","Curve");
+                model()->setData(unitIdx1,dpYUnit0);
+            }
         }
     }
 
-
     // Set presentation
     QModelIndex plotPresentationIdx = _bookModel()->getDataIndex(rootIndex(),
                                                    "PlotPresentation","Plot");
@@ -2378,6 +2236,24 @@ void CurvesView::_keyPressSpace()
     double y0 = bbox.top();
     double w = plotMathRect.width();
     double h = bbox.height();
+
+    // If zoomed into an x window, fit y to the curves in the window only
+    double yMin;
+    double yMax;
+    if ( (plotMathRect.left() > bbox.left() ||
+          plotMathRect.right() < bbox.right()) &&
+         _bookModel()->calcCurvesYRange(curvesIdx,
+                                        plotMathRect.left(),
+                                        plotMathRect.right(),
+                                        &yMin,&yMax) ) {
+        double mh = (yMax-yMin)*0.02;
+        if ( mh == 0.0 ) {
+            mh = 1.0; // Curves are flat in window
+        }
+        y0 = yMax+mh;
+        h = (yMin-mh)-y0;
+    }
+
     QRectF R(x0,y0,w,h);
     _bookModel()->setPlotMathRect(R,rootIndex());
 
@@ -19,6 +19,7 @@
 #include <QImage>
 #include <QFontMetrics>
 #include <QPoint>
+#include <QTimer>
 #include <stdlib.h>
 #include <float.h>
 #include <math.h>
@@ -27,6 +28,7 @@
 #include "curvemodel.h"
 #include "roundoff.h"
 #include "layoutitem_curves.h"
+#include "curvesrenderer.h"
 
 class TimeAndIndex
 {
@@ -147,6 +149,8 @@ private:
     void _paintErrorplot(const QTransform& T,
                          QPainter& painter, const QPen &pen,
                          const QModelIndex &plotIdx);
+    void _paintStatsplot(const QTransform& T, QPainter& painter,
+                         const QModelIndex &plotIdx);
     void _paintCurve(const QModelIndex& curveIdx,
                      const QTransform &T, QPainter& painter,
                      bool isHighlight);
@@ -155,14 +159,22 @@ private:
     QModelIndex _chooseCurveNearMousePoint(const QPoint& pt);
     bool _isErrorCurveNearMousePoint(const QPoint& pt);
 
-    QPixmap* _pixmap;
+    CurveRenderItem _curveRenderItem(const QModelIndex& curveIdx,
+                                     const QTransform &T, bool isHighlight,
+                                     const QRect& V);
+
+    CurvesRenderer* _renderer;
+    QImage _liveImage;         // curves (no background) rendered off thread
+    QTransform _liveImageT;    // transform that _liveImage was rendered with
     QRectF _lastM;
-    QPixmap* _createLivePixmap();
+    void _renderLiveImage(bool isPan=false);
 
-    QString _format(double d);
+    bool _isRenderPending;
+    bool _isPendingPan;
+    QTimer* _panSettleTimer;   // full re-render after pan strips stop
+    void _scheduleRender(bool isPan=false);
 
-    int _idxAtTimeBinarySearch(QPainterPath* path,
-                               int low, int high, double time);
+    QString _format(double d);
 
     // Key Events
     void _keyPressSpace();
@@ -178,6 +190,11 @@ protected slots:
                              const QModelIndex &bottomRight);
     virtual void rowsInserted(const QModelIndex &pidx, int start, int end);
 
+private slots:
+    void _liveImageRendered(const QImage& image, const QTransform& T);
+    void _renderScheduled();
+    void _panSettled();
+
 
 };
 
@@ -106,37 +106,43 @@ void BookTableView::paintEvent(QPaintEvent *event)
 
     // Make list of values (per column)
     QHash<int,QStringList> col2svals;
+    QHash<int,QList<bool> > col2blanks;
     for (int j = 0; j < nCols; ++j) {
         double sf   = scaleFactors.at(q+j);
         double bias = biases.at(q+j);
         CurveModel* curveModel = curveModels.at(q+j);
         curveModel->map();
-        ModelIterator* it = curveModel->begin();
         QList<double> vals;
+        QList<bool> blanks;
         for ( int i = 1; i < nRows; ++i ) {
             double t = _timeStamps.at(p+i-1);
             if ( j == 0 ) {
                 vals << t*sf + bias;
+                blanks << false;
             } else {
                 int k = curveModel->indexAtTime(t);
-                if ( it->at(k)->t() == t ) {
-                    vals << it->at(k)->y()*sf + bias;
+                double tk = 0.0;
+                double yk = 0.0;
+                if ( k >= 0 && k < curveModel->rowCount() ) {
+                    curveModel->fill(k,k+1,&tk,0,&yk);
+                }
+                if ( tk == t ) {
+                    vals << yk*sf + bias;
+                    blanks << false;
                 } else {
                     vals << 0; // place holder for blank data
+                    blanks << true;
                 }
             }
         }
         QStringList svals = _format(vals);
         col2svals.insert(j,svals);
-        delete it;
+        col2blanks.insert(j,blanks);
         curveModel->unmap();
     }
 
     // Draw the table
     for (int j = 0; j < nCols; ++j) {
-        CurveModel* curveModel = curveModels.at(q+j);
-        curveModel->map();
-        ModelIterator* it = curveModel->begin();
         for ( int i = 0; i < nRows; ++i ) {
             int hline = h*(i+1);
             int baseline = hline - _mBot - fm.descent();
@@ -149,16 +155,10 @@ void BookTableView::paintEvent(QPaintEvent *event)
                 int l = fm.width(labels.at(q+j));
                 painter.drawText(w*j+(w-l),baseline,s);
             } else {
-                if ( j == 0 ) {
+                if ( !col2blanks.value(j).at(i-1) ) {
                     s = col2svals.value(j).at(i-1);
                 } else {
-                    double t = _timeStamps.at(p+i-1);
-                    int k = curveModel->indexAtTime(t);
-                    if ( it->at(k)->t() == t ) {
-                        s = col2svals.value(j).at(i-1);
-                    } else {
-                        // s is an empty string since no corresponding time
-                    }
+                    // s is an empty string since no corresponding time
                 }
                 int l = fm.width(s);
                 painter.drawText(w*j+(w-l),baseline,s);
@@ -167,8 +167,6 @@ void BookTableView::paintEvent(QPaintEvent *event)
         int vline = w*(j+1);
         painter.setPen(penLight);
         painter.drawLine(vline,0,vline,W.height());
-        delete it;
-        curveModel->unmap();
     }
 
     painter.setPen(penOrig);
@@ -350,16 +348,27 @@ void BookTableView::dataChanged(const QModelIndex &topLeft,
             double stopTime = _bookModel()->getDataDouble(QModelIndex(),
                                                           "StopTime");
 
+            // Timestamps are read a chunk at a time
+            const int chunkSize = 8192;
             curveModel->map();
-            ModelIterator* it = curveModel->begin();
+            int n = curveModel->rowCount();
+            QVector<double> ts(qMin(n,chunkSize));
+            int tsBeg = 0;
+            int tsEnd = 0;
 
             int i = 0;
-            while ( !it->isDone() ) {
+            int j = 0;
+            while ( j < n ) {
 
-                double t = it->t();
+                if ( j >= tsEnd ) {
+                    tsBeg = j;
+                    tsEnd = qMin(j+chunkSize,n);
+                    curveModel->fill(tsBeg,tsEnd,ts.data(),0,0);
+                }
+                double t = ts.at(j-tsBeg);
 
                 if ( t < startTime ) {
-                    it->next();
+                    ++j;
                     continue;
                 }
                 if ( t > stopTime ) {
@@ -367,22 +376,21 @@ void BookTableView::dataChanged(const QModelIndex &topLeft,
                 }
                 if ( i >= _timeStamps.size() ) {
                     _timeStamps.append(t);
-                    it->next();
+                    ++j;
                     ++i;
                     continue;
                 }
 
                 double timeStamp = _timeStamps.at(i);
                 if ( t == timeStamp ) {
-                    it->next();
+                    ++j;
                 } else if ( t < timeStamp ) {
                     _timeStamps.insert(i,t);
-                    it->next();
+                    ++j;
                 }
                 ++i;
             }
 
-            delete it;
             curveModel->unmap();
         }
 
@@ -0,0 +1,248 @@
+#include "curvehitindex.h"
+
+CurveHitIndex::CurveHitIndex(const QPainterPath *path) :
+    _path(path),
+    _n(path->elementCount()),
+    _isBuilt(false),
+    _nx(1),
+    _ny(1),
+    _cellW(1.0),
+    _cellH(1.0)
+{
+}
+
+void CurveHitIndex::_build() const
+{
+    _isBuilt = true;
+    _bbox = _path->boundingRect();
+
+    int nSegs = qMax(_n-1,0);
+    if ( nSegs == 0 ) {
+        return;
+    }
+
+    // About two segments per cell
+    if ( _isMonotonicX() ) {
+        _nx = qBound(1,(nSegs+1)/2,_maxColumns);
+        _ny = 1;
+    } else {
+        int side = qBound(1,(int)ceil(sqrt(nSegs/2.0)),_maxCellsPerAxis);
+        _nx = side;
+        _ny = side;
+    }
+    if ( _bbox.width() <= 0.0 ) {
+        _nx = 1;
+    }
+    if ( _bbox.height() <= 0.0 ) {
+        _ny = 1;
+    }
+
+    // Count segments per cell, coarsening the grid while segments cross
+    // too many cells, then fill (compressed rows)
+    QVector<int> counts;
+    while ( true ) {
+        _cellW = ( _bbox.width() > 0.0 ) ? _bbox.width()/_nx : 1.0;
+        _cellH = ( _bbox.height() > 0.0 ) ? _bbox.height()/_ny : 1.0;
+        int nCells = _nx*_ny;
+        counts = QVector<int>(nCells+1,0);
+        qint64 nEntries = 0;
+        qint64 maxEntries = (qint64)_maxCellsPerSegment*nSegs+nCells;
+        for ( int i = 0; i < nSegs && nEntries <= maxEntries; ++i ) {
+            if ( _isSegment(i) ) {
+                nEntries += _walkSegment(i,counts.data(),0);
+            }
+        }
+        if ( nEntries <= maxEntries || (_nx == 1 && _ny == 1) ) {
+            break;
+        }
+        _nx = qMax(1,_nx/2);
+        _ny = qMax(1,_ny/2);
+    }
+
+    int nCells = _nx*_ny;
+    for ( int c = 0; c < nCells; ++c ) {
+        counts[c+1] += counts[c];
+    }
+    _cellBeg = counts;
+    _cellSegs = QVector<int>(counts[nCells]);
+    for ( int i = 0; i < nSegs; ++i ) {
+        if ( _isSegment(i) ) {
+            _walkSegment(i,counts.data(),_cellSegs.data());
+        }
+    }
+}
+
+// Visits the cells segment i passes through, a cell row at a time.  With
+// cellSegs null, counts the segment in counts[c+1], else puts it at
+// cellSegs[counts[c]++].  Returns the number of cells visited.
+qint64 CurveHitIndex::_walkSegment(int i, int *counts, int *cellSegs) const
+{
+    QPainterPath::Element a = _path->elementAt(i);
+    QPainterPath::Element b = _path->elementAt(i+1);
+    QRectF sbox(QPointF(qMin(a.x,b.x),qMin(a.y,b.y)),
+                QPointF(qMax(a.x,b.x),qMax(a.y,b.y)));
+    int x0, x1, y0, y1;
+    _cellRange(sbox,&x0,&x1,&y0,&y1);
+
+    qint64 nCells = 0;
+    double dy = b.y-a.y;
+    for ( int cy = y0; cy <= y1; ++cy ) {
+
+        // Part of the segment in this cell row
+        int cx0 = x0;
+        int cx1 = x1;
+        if ( y0 < y1 && dy != 0.0 ) {
+            double rowTop = _bbox.top()+cy*_cellH;
+            double ta = (rowTop-a.y)/dy;
+            double tb = (rowTop+_cellH-a.y)/dy;
+            if ( ta > tb ) {
+                qSwap(ta,tb);
+            }
+            ta = qMax(ta,0.0);
+            tb = qMin(tb,1.0);
+            double xa = a.x+ta*(b.x-a.x);
+            double xb = a.x+tb*(b.x-a.x);
+            if ( xa > xb ) {
+                qSwap(xa,xb);
+            }
+            double pad = 1.0e-9*_cellW;  // round off at cell edges
+            cx0 = qBound(x0,(int)floor((xa-pad-_bbox.left())/_cellW),x1);
+            cx1 = qBound(x0,(int)floor((xb+pad-_bbox.left())/_cellW),x1);
+        }
+
+        for ( int cx = cx0; cx <= cx1; ++cx ) {
+            int c = cy*_nx+cx;
+            if ( cellSegs ) {
+                cellSegs[counts[c]++] = i;
+            } else {
+                ++counts[c+1];
+            }
+        }
+        nCells += cx1-cx0+1;
+    }
+
+    return nCells;
+}
+
+bool CurveHitIndex::_isMonotonicX() const
+{
+    bool isUp = true;
+    bool isDown = true;
+    for ( int i = 1; i < _n && (isUp || isDown); ++i ) {
+        double dx = _path->elementAt(i).x-_path->elementAt(i-1).x;
+        if ( dx < 0.0 ) {
+            isUp = false;
+        } else if ( dx > 0.0 ) {
+            isDown = false;
+        }
+    }
+    return ( isUp || isDown );
+}
+
+// Segments are the lines drawn between consecutive elements
+bool CurveHitIndex::_isSegment(int i) const
+{
+    return _path->elementAt(i+1).isLineTo();
+}
+
+void CurveHitIndex::_cellRange(const QRectF &R,
+                               int *x0, int *x1, int *y0, int *y1) const
+{
+    *x0 = qBound(0,(int)floor((R.left()-_bbox.left())/_cellW),_nx-1);
+    *x1 = qBound(0,(int)floor((R.right()-_bbox.left())/_cellW),_nx-1);
+    *y0 = qBound(0,(int)floor((R.top()-_bbox.top())/_cellH),_ny-1);
+    *y1 = qBound(0,(int)floor((R.bottom()-_bbox.top())/_cellH),_ny-1);
+}
+
+bool CurveHitIndex::intersects(const QRectF &Rin) const
+{
+    QRectF R = Rin.normalized();
+
+    if ( _n == 1 ) {
+        QPainterPath::Element e = _path->elementAt(0);
+        return R.contains(QPointF(e.x,e.y));
+    }
+    if ( _n == 0 ) {
+        return false;
+    }
+
+    _buildMutex.lock();
+    if ( !_isBuilt ) {
+        _build();
+    }
+    _buildMutex.unlock();
+
+    // Closed bbox test (a flat curve has a zero height bbox)
+    if ( R.left() > _bbox.right() || R.right() < _bbox.left() ||
+         R.top() > _bbox.bottom() || R.bottom() < _bbox.top() ) {
+        return false;
+    }
+
+    int x0, x1, y0, y1;
+    _cellRange(R,&x0,&x1,&y0,&y1);
+    for ( int cy = y0; cy <= y1; ++cy ) {
+        for ( int cx = x0; cx <= x1; ++cx ) {
+            int c = cy*_nx+cx;
+            for ( int k = _cellBeg.at(c); k < _cellBeg.at(c+1); ++k ) {
+                int i = _cellSegs.at(k);
+                QPainterPath::Element a = _path->elementAt(i);
+                QPainterPath::Element b = _path->elementAt(i+1);
+                if ( _isSegmentInRect(a.x,a.y,b.x,b.y,R) ) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool CurveHitIndex::intersects(const QPainterPath &path, const QRectF &Rin)
+{
+    QRectF R = Rin.normalized();
+    int n = path.elementCount();
+    if ( n == 1 ) {
+        QPainterPath::Element e = path.elementAt(0);
+        return R.contains(QPointF(e.x,e.y));
+    }
+    for ( int i = 0; i < n-1; ++i ) {
+        QPainterPath::Element b = path.elementAt(i+1);
+        if ( !b.isLineTo() ) {
+            continue;
+        }
+        QPainterPath::Element a = path.elementAt(i);
+        if ( _isSegmentInRect(a.x,a.y,b.x,b.y,R) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Liang-Barsky clip of segment (x0,y0)-(x1,y1) against R (R normalized)
+bool CurveHitIndex::_isSegmentInRect(double x0, double y0,
+                                     double x1, double y1, const QRectF &R)
+{
+    double dx = x1-x0;
+    double dy = y1-y0;
+    double p[4] = { -dx, dx, -dy, dy };
+    double q[4] = { x0-R.left(), R.right()-x0, y0-R.top(), R.bottom()-y0 };
+    double u0 = 0.0;
+    double u1 = 1.0;
+    for ( int k = 0; k < 4; ++k ) {
+        if ( p[k] == 0.0 ) {
+            if ( q[k] < 0.0 ) {
+                return false;  // parallel to and outside of this edge
+            }
+        } else {
+            double u = q[k]/p[k];
+            if ( p[k] < 0.0 ) {
+                if ( u > u1 ) return false;
+                if ( u > u0 ) u0 = u;
+            } else {
+                if ( u < u0 ) return false;
+                if ( u < u1 ) u1 = u;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef CURVEHITINDEX_H
+#define CURVEHITINDEX_H
+
+#include <QPainterPath>
+#include <QRectF>
+#include <QVector>
+#include <QMutex>
+#include <QMutexLocker>
+#include <math.h>
+
+// Bucket grid over a curve's painter path segments for hit testing
+//
+// The path's bounding box is split into a grid of cells.  Each cell
+// lists the segments that pass through it (walked a cell row at a time),
+// so a small query rect only tests the few segments near it.  When x is
+// monotonic (e.g. time) segments partition x and the grid is columns
+// only.  Otherwise the grid is coarsened until segments cross a few
+// cells on average, which keeps noisy curves from listing every
+// segment in every row.
+//
+// The grid is built on the first query (i.e. the first click near the
+// curve), not with the path.
+//
+// Like CurveLod, the index refers to the path's elements and must not
+// outlive the path it was built from.
+class CurveHitIndex
+{
+public:
+    CurveHitIndex(const QPainterPath* path);
+
+    // True if the path passes through R (in path coordinates)
+    bool intersects(const QRectF& R) const;
+
+    // Same test on any path, without an index (linear in path size)
+    static bool intersects(const QPainterPath& path, const QRectF& R);
+
+private:
+    const QPainterPath* _path;
+    int _n;
+
+    mutable QMutex _buildMutex;
+    mutable bool _isBuilt;
+    mutable QRectF _bbox;
+    mutable int _nx;
+    mutable int _ny;
+    mutable double _cellW;
+    mutable double _cellH;
+    mutable QVector<int> _cellBeg;   // segs of cell c: _cellSegs[_cellBeg[c]..]
+    mutable QVector<int> _cellSegs;  // segment i goes from element i to i+1
+
+    void _build() const;
+    qint64 _walkSegment(int i, int* counts, int* cellSegs) const;
+    bool _isMonotonicX() const;
+    bool _isSegment(int i) const;
+    void _cellRange(const QRectF& R, int* x0, int* x1, int* y0, int* y1) const;
+
+    static bool _isSegmentInRect(double x0, double y0,
+                                 double x1, double y1, const QRectF& R);
+
+    static const int _maxCellsPerSegment = 4;  // on average
+    static const int _maxCellsPerAxis = 256;
+    static const int _maxColumns = 65536;
+};
+
+#endif // CURVEHITINDEX_H
@@ -0,0 +1,253 @@
+#include "curvelod.h"
+
+CurveLod::CurveLod(const QPainterPath *path) :
+    _path(path),
+    _n(path->elementCount()),
+    _isMonotonic(true)
+{
+    if ( _n > 0 ) {
+        double xMin = _x(0);
+        double xMax = xMin;
+        double yMin = _y(0);
+        double yMax = yMin;
+        for ( int i = 1; i < _n; ++i ) {
+            double x = _x(i);
+            double y = _y(i);
+            if ( x < _x(i-1) ) {
+                _isMonotonic = false;
+            }
+            if ( x < xMin ) xMin = x;
+            if ( x > xMax ) xMax = x;
+            if ( y < yMin ) yMin = y;
+            if ( y > yMax ) yMax = y;
+        }
+        _bbox = QRectF(QPointF(xMin,yMin),QPointF(xMax,yMax));
+    }
+
+    if ( _isMonotonic ) {
+        _build();
+    }
+}
+
+void CurveLod::_build()
+{
+    // Level 0 from path elements
+    int nBuckets = (_n+_fanout-1)/_fanout;
+    if ( nBuckets <= 1 ) {
+        return;
+    }
+    QVector<int> mins(nBuckets);
+    QVector<int> maxs(nBuckets);
+    for ( int b = 0; b < nBuckets; ++b ) {
+        int i = b*_fanout;
+        int end = qMin(i+_fanout,_n);
+        int iMin = i;
+        int iMax = i;
+        for ( ++i; i < end; ++i ) {
+            double y = _y(i);
+            if ( y < _y(iMin) ) iMin = i;
+            if ( y > _y(iMax) ) iMax = i;
+        }
+        mins[b] = iMin;
+        maxs[b] = iMax;
+    }
+    _mins.append(mins);
+    _maxs.append(maxs);
+
+    // Each level above reduces the level below by _fanout
+    while ( nBuckets > 1 ) {
+        const QVector<int>& lmins = _mins.last();
+        const QVector<int>& lmaxs = _maxs.last();
+        int nLower = nBuckets;
+        nBuckets = (nLower+_fanout-1)/_fanout;
+        mins = QVector<int>(nBuckets);
+        maxs = QVector<int>(nBuckets);
+        for ( int b = 0; b < nBuckets; ++b ) {
+            int j = b*_fanout;
+            int end = qMin(j+_fanout,nLower);
+            int iMin = lmins.at(j);
+            int iMax = lmaxs.at(j);
+            for ( ++j; j < end; ++j ) {
+                if ( _y(lmins.at(j)) < _y(iMin) ) iMin = lmins.at(j);
+                if ( _y(lmaxs.at(j)) > _y(iMax) ) iMax = lmaxs.at(j);
+            }
+            mins[b] = iMin;
+            maxs[b] = iMax;
+        }
+        _mins.append(mins);
+        _maxs.append(maxs);
+    }
+}
+
+// First element with x >= xIn
+int CurveLod::_lowerBound(double xIn) const
+{
+    int lo = 0;
+    int hi = _n;
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( _x(mid) < xIn ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// First element with x > xIn
+int CurveLod::_upperBound(double xIn) const
+{
+    int lo = 0;
+    int hi = _n;
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( _x(mid) <= xIn ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Returns path vertices within [x0,x1] (plus a neighbor on each side so
+// the line runs off the window edges).  If the window holds more than
+// two vertices per pixel, the smallest pyramid level with at least a
+// pixel's worth of elements per bucket is used, emitting each bucket's
+// min and max in path order.
+QPolygonF CurveLod::polyline(double x0, double x1, int pixelWidth) const
+{
+    QPolygonF pts;
+
+    if ( _n == 0 || !_isMonotonic ) {
+        return pts;
+    }
+
+    int a = qMax(_lowerBound(x0)-1,0);
+    int b = qMin(_upperBound(x1),_n-1);
+    if ( a > b ) {
+        return pts;
+    }
+
+    int count = b-a+1;
+    if ( pixelWidth <= 0 || count <= 2*pixelWidth || _mins.isEmpty() ) {
+        pts.reserve(count);
+        for ( int i = a; i <= b; ++i ) {
+            pts.append(QPointF(_x(i),_y(i)));
+        }
+        return pts;
+    }
+
+    double elsPerPixel = (double)count/(double)pixelWidth;
+    int level = 0;
+    int bucketSize = _fanout;
+    while ( bucketSize < elsPerPixel && level < _mins.size()-1 ) {
+        ++level;
+        bucketSize *= _fanout;
+    }
+
+    const QVector<int>& mins = _mins.at(level);
+    const QVector<int>& maxs = _maxs.at(level);
+    int bBeg = a/bucketSize;
+    int bEnd = b/bucketSize;
+    pts.reserve(2*(bEnd-bBeg+1)+2);
+
+    int iLast = -1;
+    if ( mins.at(bBeg) > a && maxs.at(bBeg) > a ) {
+        pts.append(QPointF(_x(a),_y(a)));
+        iLast = a;
+    }
+    for ( int k = bBeg; k <= bEnd; ++k ) {
+        int i = qMin(mins.at(k),maxs.at(k));
+        int j = qMax(mins.at(k),maxs.at(k));
+        if ( i > iLast ) {
+            pts.append(QPointF(_x(i),_y(i)));
+            iLast = i;
+        }
+        if ( j > iLast ) {
+            pts.append(QPointF(_x(j),_y(j)));
+            iLast = j;
+        }
+    }
+    if ( b > iLast ) {
+        pts.append(QPointF(_x(b),_y(b)));
+    }
+
+    return pts;
+}
+
+// Walks up the pyramid: ends of the window that don't fill a whole bucket
+// of the next level are taken at the current level
+bool CurveLod::yRange(double x0, double x1,
+                      double *yMin, double *yMax) const
+{
+    if ( _n == 0 ) {
+        return false;
+    }
+
+    if ( !_isMonotonic ) {
+        bool isFound = false;
+        for ( int i = 0; i < _n; ++i ) {
+            double x = _x(i);
+            if ( x < x0 || x > x1 ) {
+                continue;
+            }
+            double y = _y(i);
+            if ( !isFound ) {
+                *yMin = y;
+                *yMax = y;
+                isFound = true;
+            } else {
+                if ( y < *yMin ) *yMin = y;
+                if ( y > *yMax ) *yMax = y;
+            }
+        }
+        return isFound;
+    }
+
+    int lo = _lowerBound(x0);
+    int hi = _upperBound(x1);  // exclusive
+    if ( lo >= hi ) {
+        return false;
+    }
+
+    *yMin = _y(lo);
+    *yMax = _y(lo);
+    int level = -1;  // -1 is the path elements themselves
+    while ( lo < hi ) {
+        if ( level+1 < _mins.size() && hi-lo >= 2*_fanout ) {
+            while ( lo%_fanout != 0 ) {
+                _yRangeTake(level,lo++,yMin,yMax);
+            }
+            while ( hi%_fanout != 0 ) {
+                _yRangeTake(level,--hi,yMin,yMax);
+            }
+            lo /= _fanout;
+            hi /= _fanout;
+            ++level;
+        } else {
+            while ( lo < hi ) {
+                _yRangeTake(level,lo++,yMin,yMax);
+            }
+        }
+    }
+
+    return true;
+}
+
+void CurveLod::_yRangeTake(int level, int k,
+                           double *yMin, double *yMax) const
+{
+    double a;
+    double b;
+    if ( level < 0 ) {
+        a = _y(k);
+        b = a;
+    } else {
+        a = _y(_mins.at(level).at(k));
+        b = _y(_maxs.at(level).at(k));
+    }
+    if ( a < *yMin ) *yMin = a;
+    if ( b > *yMax ) *yMax = b;
+}
@@ -0,0 +1,55 @@
+#ifndef CURVELOD_H
+#define CURVELOD_H
+
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+// Level-of-detail min/max pyramid over a curve's painter path
+//
+// Level k buckets span 4^(k+1) consecutive path elements and hold the
+// element indices of the bucket's min and max y.  When the path's x is
+// monotonic (e.g. time), polyline() reduces a visible x window to about
+// two vertices per pixel column while keeping every spike.  The same
+// buckets answer yRange() for an x window in O(log n).  The path's
+// bounding box is computed once when the pyramid is built.
+//
+// The pyramid refers to the path's elements and does not copy them,
+// so it must not outlive the path it was built from.
+class CurveLod
+{
+public:
+    CurveLod(const QPainterPath* path);
+
+    bool isMonotonic() const { return _isMonotonic; }
+    int levelCount() const { return _mins.size(); }
+    int count() const { return _n; }
+    QRectF boundingRect() const { return _bbox; }
+
+    QPolygonF polyline(double x0, double x1, int pixelWidth) const;
+
+    // Min/max y of the elements with x in [x0,x1].  Returns false if
+    // there are none.
+    bool yRange(double x0, double x1, double* yMin, double* yMax) const;
+
+private:
+    const QPainterPath* _path;
+    int _n;
+    bool _isMonotonic;
+    QRectF _bbox;
+
+    QVector<QVector<int> > _mins;  // _mins[level][bucket] -> element idx
+    QVector<QVector<int> > _maxs;
+
+    void _build();
+    int _lowerBound(double x) const;
+    int _upperBound(double x) const;
+    void _yRangeTake(int level, int k, double* yMin, double* yMax) const;
+    inline double _x(int i) const { return _path->elementAt(i).x; }
+    inline double _y(int i) const { return _path->elementAt(i).y; }
+
+    static const int _fanout = 4;
+};
+
+#endif // CURVELOD_H
@@ -24,11 +24,17 @@ class CurveModel : public QAbstractTableModel
     CurveModelParameter* y() { return _y; }
 
     QString fileName() const { return _datamodel->fileName(); }
+    const DataModel* dataModel() const { return _datamodel; }
+    int tcol() const { return _tcol; }
 
     void map() { _datamodel->map(); }
     void unmap() { _datamodel->unmap(); }
     ModelIterator* begin() const { return _datamodel->begin(_tcol,_xcol,_ycol);}
     int indexAtTime(double time) { return _datamodel->indexAtTime(time); }
+    void fill(int row0, int row1, double* t, double* x, double* y) const
+    {
+        _datamodel->fill(_tcol,_xcol,_ycol,row0,row1,t,x,y);
+    }
 
     virtual int rowCount(const QModelIndex & pidx = QModelIndex() ) const;
     virtual int columnCount(const QModelIndex & pidx = QModelIndex() ) const;
@@ -0,0 +1,249 @@
+#include "curvepathbuild.h"
+#include <QVector>
+#include <float.h>
+#include <math.h>
+
+CurvePathSpec::CurvePathSpec() :
+    startTime(-DBL_MAX),
+    stopTime(DBL_MAX),
+    xs(1.0),
+    xb(0.0),
+    ys(1.0),
+    yb(0.0),
+    plotXScale("linear"),
+    plotYScale("linear"),
+    frequency(0.0),
+    isStatistics(false)
+{
+}
+
+bool CurvePathSpec::operator==(const CurvePathSpec &other) const
+{
+    return ( startTime == other.startTime && stopTime == other.stopTime &&
+             xs == other.xs && xb == other.xb &&
+             ys == other.ys && yb == other.yb &&
+             plotXScale == other.plotXScale &&
+             plotYScale == other.plotYScale &&
+             frequency == other.frequency &&
+             isStatistics == other.isStatistics );
+}
+
+CurvePathBuild::CurvePathBuild(CurveModel *curveModel,
+                               const CurvePathSpec &spec,
+                               CurveTimeIndex *timeIndex) :
+    _curveModel(curveModel),
+    _spec(spec),
+    _path(0),
+    _lod(0),
+    _hitIndex(0),
+    _timeIndex(timeIndex)
+{
+}
+
+CurvePathBuild::~CurvePathBuild()
+{
+    delete _path;
+    delete _lod;
+    delete _hitIndex;
+    CurveTimeIndex::release(_timeIndex);
+}
+
+void CurvePathBuild::build(const QAtomicInt *generation, int buildGeneration)
+{
+    // The time index depends only on the curve's data, so it is reused
+    // when the path is rebuilt and shared with curves of the same times
+    if ( !_timeIndex ) {
+        _timeIndex = CurveTimeIndex::acquire(_curveModel);
+    }
+
+    delete _path;
+    delete _lod;
+    delete _hitIndex;
+    if ( _spec.isStatistics ) {
+        // The curve isn't drawn, its plot's statistics bands are
+        _path = 0;
+        _lod = 0;
+        _hitIndex = 0;
+        return;
+    }
+    _path = _createPath(_curveModel,_spec,_timeIndex,
+                        generation,buildGeneration);
+    if ( generation &&
+         generation->fetchAndAddOrdered(0) != buildGeneration ) {
+        _lod = 0;
+        _hitIndex = 0;
+        return;
+    }
+    _lod = new CurveLod(_path);
+    _hitIndex = new CurveHitIndex(_path);
+}
+
+QPainterPath* CurvePathBuild::takePath()
+{
+    QPainterPath* path = _path;
+    _path = 0;
+    return path;
+}
+
+CurveLod* CurvePathBuild::takeLod()
+{
+    CurveLod* lod = _lod;
+    _lod = 0;
+    return lod;
+}
+
+CurveHitIndex* CurvePathBuild::takeHitIndex()
+{
+    CurveHitIndex* hitIndex = _hitIndex;
+    _hitIndex = 0;
+    return hitIndex;
+}
+
+CurveTimeIndex* CurvePathBuild::takeTimeIndex()
+{
+    CurveTimeIndex* timeIndex = _timeIndex;
+    _timeIndex = 0;
+    return timeIndex;
+}
+
+// Note:
+//   No scaling or bias is done linear plot scale since it is done
+//   via the paint transform. For log scale, the path is scaled/biased.
+QPainterPath* CurvePathBuild::_createPath(CurveModel *curveModel,
+                                          const CurvePathSpec &spec,
+                                          const CurveTimeIndex *timeIndex,
+                                          const QAtomicInt *generation,
+                                          int buildGeneration)
+{
+    QPainterPath* path = new QPainterPath;
+
+    curveModel->map();
+
+    bool isXLogScale = ( spec.plotXScale == "log" ) ? true : false;
+    bool isYLogScale = ( spec.plotYScale == "log" ) ? true : false;
+
+    double f = spec.frequency;
+    bool isFirst = true;
+
+    // If time is sorted, only rows within [startTime,stopTime] are read
+    int rowBeg = 0;
+    int rowEnd = curveModel->rowCount();
+    bool isSorted = timeIndex->isMonotonic() &&
+                    timeIndex->count() == rowEnd;
+    if ( isSorted ) {
+        rowBeg = timeIndex->lowerBound(spec.startTime);
+        rowEnd = timeIndex->upperBound(spec.stopTime);
+    }
+
+    // If there are fewer multiples of the frequency than rows in the
+    // window, the rows on them are looked up instead of testing every row
+    QVector<int> freqRows;
+    bool isFreqRows = false;
+    if ( f > 0.0 && isSorted && rowBeg < rowEnd ) {
+        const double tol = 1.0e-9;
+        double m0 = ceil((timeIndex->time(rowBeg)-tol)/f);
+        double m1 = floor((timeIndex->time(rowEnd-1)+tol)/f);
+        if ( m1-m0+1 < rowEnd-rowBeg ) {
+            isFreqRows = true;
+            int next = rowBeg;
+            for ( double m = m0; m <= m1; m += 1.0 ) {
+                double tm = m*f;
+                int a = qMax(timeIndex->lowerBound(tm-2.0*tol),next);
+                int b = qMin(timeIndex->upperBound(tm+2.0*tol),rowEnd);
+                for ( int row = a; row < b; ++row ) {
+                    double t = timeIndex->time(row);
+                    if ( fabs(t-round(t/f)*f) <= tol ) {
+                        freqRows.append(row);
+                        next = row+1;
+                    }
+                }
+            }
+        }
+    }
+    bool isTestFreq = ( f > 0.0 && !isFreqRows );
+
+    // Read samples a chunk at a time
+    const int chunkSize = 8192;
+    QVector<double> tChunk(chunkSize);
+    QVector<double> xChunk(chunkSize);
+    QVector<double> yChunk(chunkSize);
+    int nrows = isFreqRows ? freqRows.size() : rowEnd-rowBeg;
+    for ( int row0 = 0; row0 < nrows; row0 += chunkSize ) {
+        if ( generation &&
+             generation->fetchAndAddOrdered(0) != buildGeneration ) {
+            break; // canceled
+        }
+        int nChunk = qMin(chunkSize,nrows-row0);
+        if ( isFreqRows ) {
+            for ( int i = 0; i < nChunk; ++i ) {
+                int row = freqRows.at(row0+i);
+                curveModel->fill(row,row+1,tChunk.data()+i,
+                                 xChunk.data()+i,yChunk.data()+i);
+            }
+        } else {
+            curveModel->fill(rowBeg+row0,rowBeg+row0+nChunk,
+                             tChunk.data(),xChunk.data(),yChunk.data());
+        }
+        for ( int i = 0; i < nChunk; ++i ) {
+            double t = tChunk.at(i);
+            if ( isTestFreq ) {
+                if ( fabs(t-round(t/f)*f) > 1.0e-9 ) { // t not divisible by f?
+                    continue;
+                }
+            }
+            if ( t < spec.startTime || t > spec.stopTime ) {
+                continue;
+            }
+
+            double x = xChunk.at(i);
+            double y = yChunk.at(i);
+
+            if ( isXLogScale ) {
+                x = x*spec.xs + spec.xb;
+                if ( x > 0 ) {
+                    x = log10(x);
+                } else if ( x < 0 ) {
+                    x = log10(-x);
+                } else if ( x == 0 ) {
+                    continue; // skip log(0) since -inf
+                }
+            }
+
+            if ( isYLogScale ) {
+                y = y*spec.ys + spec.yb;
+                if ( y > 0 ) {
+                    y = log10(y);
+                } else if ( y < 0 ) {
+                    y = log10(-y);
+                } else if ( y == 0 ) {
+                    continue; // skip log(0) since -inf
+                }
+            }
+
+            if ( isFirst ) {
+                path->moveTo(x,y);
+                isFirst = false;
+            } else {
+                int m = path->elementCount();
+                path->lineTo(x,y);
+                int n = path->elementCount();
+                if ( m == n ) {
+                    /* When points are very close to one another,
+                     * it looks like Qt will skip adding a lineTo(x,y).
+                     * This bit of code tries to force Qt to add the
+                     * lineTo(x,y) no matter how close the two points
+                     * are to one another.
+                     */
+                    path->lineTo(x+1.0,y+1.0);
+                    int o = path->elementCount();
+                    if ( o > m ) {
+                        path->setElementPositionAt(o-1,x,y);
+                    }
+                }
+            }
+        }
+    }
+    curveModel->unmap();
+
+    return path;
+}
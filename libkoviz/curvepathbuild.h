@@ -0,0 +1,81 @@
+#ifndef CURVEPATHBUILD_H
+#define CURVEPATHBUILD_H
+
+#include <QPainterPath>
+#include <QString>
+#include <QAtomicInt>
+#include "curvemodel.h"
+#include "curvelod.h"
+#include "curvehitindex.h"
+#include "curvetimeindex.h"
+
+// What a curve's painter path is made from (see
+// PlotBookModel::curvePathSpec())
+class CurvePathSpec
+{
+  public:
+    CurvePathSpec();
+
+    double startTime;     // in logged time (time shift/scale undone)
+    double stopTime;
+    double xs;            // only applied to the path on log scales
+    double xb;
+    double ys;
+    double yb;
+    QString plotXScale;
+    QString plotYScale;
+    double frequency;     // 0.0 is all data
+    bool isStatistics;    // plot draws statistics, so only the time index
+
+    bool operator==(const CurvePathSpec& other) const;
+    bool operator!=(const CurvePathSpec& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// A curve's painter path with its level-of-detail pyramid, hit test
+// index and time index
+//
+// build() only reads the curve's data, so builds can run on pool
+// threads (see CurvesLoader).  The book model takes the results over
+// when the curve's data is set in the book.
+class CurvePathBuild
+{
+  public:
+    // timeIndex (a reference the build releases from here on) is
+    // acquired if not given
+    CurvePathBuild(CurveModel* curveModel, const CurvePathSpec& spec,
+                   CurveTimeIndex* timeIndex=0);
+    ~CurvePathBuild();
+
+    // Gives up (with incomplete results) once *generation is no longer
+    // buildGeneration, e.g. when the curves loader is canceled
+    void build(const QAtomicInt* generation=0, int buildGeneration=0);
+
+    CurveModel* curveModel() const { return _curveModel; }
+    const CurvePathSpec& spec() const { return _spec; }
+
+    // Hand the results over to the caller (with the time index comes
+    // its reference, see CurveTimeIndex::release())
+    QPainterPath* takePath();
+    CurveLod* takeLod();
+    CurveHitIndex* takeHitIndex();
+    CurveTimeIndex* takeTimeIndex();
+
+  private:
+    CurveModel* _curveModel;
+    CurvePathSpec _spec;
+    QPainterPath* _path;
+    CurveLod* _lod;
+    CurveHitIndex* _hitIndex;
+    CurveTimeIndex* _timeIndex;
+
+    static QPainterPath* _createPath(CurveModel* curveModel,
+                                     const CurvePathSpec& spec,
+                                     const CurveTimeIndex* timeIndex,
+                                     const QAtomicInt* generation,
+                                     int buildGeneration);
+};
+
+#endif // CURVEPATHBUILD_H
@@ -0,0 +1,128 @@
+#include "curveprops.h"
+#include "unit.h"
+#include "utils.h"
+#include <float.h>
+
+CurveProps::CurveProps() :
+    runID(-1),
+    xScale(1.0),
+    xBias(0.0),
+    yScale(1.0),
+    yBias(0.0),
+    xMinRange(-DBL_MAX),
+    xMaxRange(DBL_MAX),
+    yMinRange(-DBL_MAX),
+    yMaxRange(DBL_MAX),
+    curveModel(0),
+    xs(0.0),
+    xb(0.0),
+    ys(0.0),
+    yb(0.0)
+{
+}
+
+CurveItem::CurveItem(const QString &text) :
+    QStandardItem(text),
+    _isDirty(true)
+{
+}
+
+const CurveProps &CurveItem::props()
+{
+    if ( _isDirty ) {
+        _fill();
+    }
+    return _props;
+}
+
+void CurveItem::_fill()
+{
+    CurveProps p;
+
+    int rc = rowCount();
+    for ( int i = 0; i < rc; ++i ) {
+        QStandardItem* tagItem = child(i,0);
+        QStandardItem* valItem = child(i,1);
+        if ( !tagItem || !valItem ) {
+            continue;
+        }
+        QString tag = tagItem->text();
+        QVariant v = valItem->data(Qt::DisplayRole);
+        if ( tag == "CurveRunID" ) {
+            p.runID = v.toInt();
+        } else if ( tag == "CurveTimeName" ) {
+            p.timeName = v.toString();
+        } else if ( tag == "CurveTimeUnit" ) {
+            p.timeUnit = v.toString();
+        } else if ( tag == "CurveXName" ) {
+            p.xName = v.toString();
+        } else if ( tag == "CurveXUnit" ) {
+            p.xUnit = v.toString();
+        } else if ( tag == "CurveYName" ) {
+            p.yName = v.toString();
+        } else if ( tag == "CurveYUnit" ) {
+            p.yUnit = v.toString();
+        } else if ( tag == "CurveXScale" ) {
+            p.xScale = v.toDouble();
+        } else if ( tag == "CurveXBias" ) {
+            p.xBias = v.toDouble();
+        } else if ( tag == "CurveYScale" ) {
+            p.yScale = v.toDouble();
+        } else if ( tag == "CurveYBias" ) {
+            p.yBias = v.toDouble();
+        } else if ( tag == "CurveXMinRange" ) {
+            p.xMinRange = v.toDouble();
+        } else if ( tag == "CurveXMaxRange" ) {
+            p.xMaxRange = v.toDouble();
+        } else if ( tag == "CurveYMinRange" ) {
+            p.yMinRange = v.toDouble();
+        } else if ( tag == "CurveYMaxRange" ) {
+            p.yMaxRange = v.toDouble();
+        } else if ( tag == "CurveYLabel" ) {
+            p.yLabel = v.toString();
+        } else if ( tag == "CurveColor" ) {
+            p.color = v.toString();
+        } else if ( tag == "CurveLineStyle" ) {
+            p.lineStyle = v.toString();
+        } else if ( tag == "CurveSymbolStyle" ) {
+            p.symbolStyle = v.toString();
+        } else if ( tag == "CurveSymbolSize" ) {
+            p.symbolSize = v.toString();
+        } else if ( tag == "CurveData" ) {
+            p.curveModel = QVariantToPtr<CurveModel>::convert(v);
+        }
+    }
+
+    if ( p.curveModel ) {
+        p.xs = 1.0;
+        p.xb = 0.0;
+        if ( !p.xUnit.isEmpty() && p.xUnit != "--" ) {
+            QString loggedXUnit = p.curveModel->x()->unit();
+            p.xs = Unit::scale(loggedXUnit,p.xUnit);
+            p.xb = Unit::bias(loggedXUnit,p.xUnit);
+        }
+        if ( p.xScale != 1.0 ) {
+            p.xs *= p.xScale;
+        }
+        if ( p.xBias != 0.0 ) {
+            p.xb += p.xBias;
+        }
+
+        p.ys = 1.0;
+        p.yb = 0.0;
+        if ( !p.yUnit.isEmpty() && p.yUnit != "--" ) {
+            QString loggedYUnit = p.curveModel->y()->unit();
+            p.ys = Unit::scale(loggedYUnit,p.yUnit);
+            p.yb = Unit::bias(loggedYUnit,p.yUnit);
+        }
+        if ( p.yScale != 1.0 ) {
+            p.ys *= p.yScale;
+        }
+        if ( p.yBias != 0.0 ) {
+            p.yb += p.yBias;
+        }
+    }
+
+    _props = p;
+    _isDirty = false;
+}
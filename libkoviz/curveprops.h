@@ -0,0 +1,72 @@
+#ifndef CURVEPROPS_H
+#define CURVEPROPS_H
+
+#include <QStandardItem>
+#include <QString>
+#include "curvemodel.h"
+
+// A Curve item's tagged children (CurveColor, CurveYScale...) as fields
+//
+// The children are still what gets edited, saved and shown in the DP
+// tree.  The record is refilled from them after they change, so reading
+// a curve property is a field access instead of a getIndex() scan over
+// the ~20 children.
+class CurveProps
+{
+  public:
+    CurveProps();
+
+    int runID;
+    QString timeName;
+    QString timeUnit;
+    QString xName;
+    QString xUnit;
+    QString yName;
+    QString yUnit;
+    double xScale;          // book scale/bias, without unit conversion
+    double xBias;
+    double yScale;
+    double yBias;
+    double xMinRange;
+    double xMaxRange;
+    double yMinRange;
+    double yMaxRange;
+    QString yLabel;
+    QString color;
+    QString lineStyle;
+    QString symbolStyle;
+    QString symbolSize;
+    CurveModel* curveModel; // 0 until CurveData is set
+
+    // Logged to book, i.e. unit conversion with book scale/bias (as
+    // PlotBookModel::xScale() etc., which are 0 without a curve model)
+    double xs;
+    double xb;
+    double ys;
+    double yb;
+};
+
+// The "Curve" item of the book, it keeps its children's CurveProps
+class CurveItem : public QStandardItem
+{
+  public:
+    enum { Type = QStandardItem::UserType+1 };
+
+    explicit CurveItem(const QString& text);
+
+    virtual int type() const { return Type; }
+    virtual QStandardItem* clone() const { return new CurveItem(text()); }
+
+    // Children changed (the props are refilled on the next read)
+    void setDirty() { _isDirty = true; }
+
+    const CurveProps& props();
+
+  private:
+    CurveProps _props;
+    bool _isDirty;
+
+    void _fill();
+};
+
+#endif // CURVEPROPS_H
@@ -0,0 +1,92 @@
+#include "curvesloader.h"
+
+//
+// Pool task
+//
+class CurvesLoadTask : public QRunnable
+{
+  public:
+    CurvesLoadTask(CurvesLoader* loader, CurvePathBuild* build,
+                   int generation) :
+        _loader(loader), _build(build), _generation(generation) {}
+
+    void run()
+    {
+        if ( _loader->_generation.fetchAndAddOrdered(0) == _generation ) {
+            _build->build(&_loader->_generation,_generation);
+        }
+
+        // Canceled builds go back too so that they get deleted
+        QMutexLocker locker(&_loader->_doneMutex);
+        _loader->_done.append(qMakePair(_build,_generation));
+        if ( _loader->_done.size() == 1 ) {
+            QMetaObject::invokeMethod(_loader,"_handBack",
+                                      Qt::QueuedConnection);
+        }
+    }
+
+  private:
+    CurvesLoader* _loader;
+    CurvePathBuild* _build;
+    int _generation;
+};
+
+//
+// CurvesLoader
+//
+CurvesLoader::CurvesLoader(QObject *parent) :
+    QObject(parent),
+    _generation(0)
+{
+    _pool.setMaxThreadCount(qMax(QThread::idealThreadCount(),1));
+}
+
+CurvesLoader::~CurvesLoader()
+{
+    cancel();
+    _pool.waitForDone();
+
+    QPair<CurvePathBuild*,int> done;
+    foreach ( done, _done ) {
+        delete done.first->curveModel();
+        delete done.first;
+    }
+    _done.clear();
+}
+
+void CurvesLoader::load(CurvePathBuild *build)
+{
+    int generation = _generation.fetchAndAddOrdered(0);
+    _pool.start(new CurvesLoadTask(this,build,generation));
+}
+
+void CurvesLoader::cancel()
+{
+    _generation.fetchAndAddOrdered(1);
+}
+
+void CurvesLoader::waitForDone()
+{
+    _pool.waitForDone();
+    _handBack();
+}
+
+void CurvesLoader::_handBack()
+{
+    QList<QPair<CurvePathBuild*,int> > done;
+    _doneMutex.lock();
+    done = _done;
+    _done.clear();
+    _doneMutex.unlock();
+
+    // Receivers may cancel while builds are handed back
+    for ( int i = 0; i < done.size(); ++i ) {
+        CurvePathBuild* build = done.at(i).first;
+        if ( done.at(i).second == _generation.fetchAndAddOrdered(0) ) {
+            emit built(build);
+        } else {
+            delete build->curveModel();
+            delete build;
+        }
+    }
+}
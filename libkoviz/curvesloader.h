@@ -0,0 +1,53 @@
+#ifndef CURVESLOADER_H
+#define CURVESLOADER_H
+
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QList>
+#include <QPair>
+#include "curvepathbuild.h"
+
+// Builds curve paths on pool threads, one task per curve
+//
+// Finished builds are handed back on the GUI thread via built(), about
+// in the order load() was called.  cancel() makes queued and running
+// tasks give up, and their builds (and curve models) are deleted rather
+// than handed back.  Without an event loop (e.g. -pdf), waitForDone()
+// hands back every build loaded so far.
+class CurvesLoader : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit CurvesLoader(QObject* parent = 0);
+    ~CurvesLoader();
+
+    void load(CurvePathBuild* build);  // takes ownership
+    void cancel();
+    void waitForDone();
+
+  signals:
+    // Receiver owns build and its curve model
+    void built(CurvePathBuild* build);
+
+  private slots:
+    void _handBack();
+
+  private:
+    QThreadPool _pool;
+    QAtomicInt _generation;
+
+    // Finished builds (with the generation they were loaded in) waiting
+    // for _handBack() on the GUI thread
+    QMutex _doneMutex;
+    QList<QPair<CurvePathBuild*,int> > _done;
+
+    friend class CurvesLoadTask;
+};
+
+#endif // CURVESLOADER_H
@@ -0,0 +1,405 @@
+#include "curvesrenderer.h"
+
+#include <qmath.h>
+#include <QFontMetrics>
+#include <QLineF>
+#include <math.h>
+
+//
+// Pool task
+//
+class CurvesRenderTask : public QRunnable
+{
+  public:
+    CurvesRenderTask(const QSharedPointer<CurvesRenderState>& state,
+                     const CurvesRenderJob& job, int generation) :
+        _state(state), _job(job), _generation(generation) {}
+
+    void run()
+    {
+        if ( !_isCurrent() ) {
+            return;
+        }
+
+        QImage image(_job.size,QImage::Format_ARGB32_Premultiplied);
+        image.fill(0);  // transparent
+
+        QPainter painter(&image);
+        if ( !_job.base.isNull() ) {
+            painter.drawImage(_job.baseOffset,_job.base);
+            painter.setClipRegion(_job.exposed);
+        }
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setFont(_job.font);
+        foreach ( CurveRenderItem item, _job.items ) {
+            if ( !_isCurrent() ) {
+                return;  // a newer job replaces this one
+            }
+            CurvesRenderer::paintCurve(item,painter);
+        }
+        painter.end();
+
+        QMutexLocker locker(&_state->mutex);
+        if ( _state->renderer && _isCurrent() ) {
+            QMetaObject::invokeMethod(_state->renderer,"_jobDone",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QImage,image),
+                                      Q_ARG(QTransform,_job.T),
+                                      Q_ARG(int,_generation));
+        }
+    }
+
+  private:
+    QSharedPointer<CurvesRenderState> _state;
+    CurvesRenderJob _job;
+    int _generation;
+
+    bool _isCurrent() const
+    {
+        return ( _state->generation.fetchAndAddOrdered(0) == _generation );
+    }
+};
+
+//
+// CurvesRenderer
+//
+CurvesRenderer::CurvesRenderer(QObject *parent) :
+    QObject(parent),
+    _state(new CurvesRenderState(this))
+{
+}
+
+CurvesRenderer::~CurvesRenderer()
+{
+    cancel();
+    QMutexLocker locker(&_state->mutex);
+    _state->renderer = 0;
+}
+
+QThreadPool* CurvesRenderer::_pool()
+{
+    static QThreadPool pool;
+    return &pool;
+}
+
+void CurvesRenderer::render(const CurvesRenderJob &job)
+{
+    int generation = _state->generation.fetchAndAddOrdered(1)+1;
+    _pool()->start(new CurvesRenderTask(_state,job,generation));
+}
+
+// Drops the running job (if any) without starting another
+void CurvesRenderer::cancel()
+{
+    _state->generation.fetchAndAddOrdered(1);
+}
+
+void CurvesRenderer::_jobDone(const QImage &image, const QTransform &T,
+                              int generation)
+{
+    if ( _state->generation.fetchAndAddOrdered(0) == generation ) {
+        emit rendered(image,T);
+    }
+}
+
+void CurvesRenderer::paintCurve(const CurveRenderItem &item,
+                                QPainter &painter)
+{
+    painter.save();
+
+    QPen pen;
+    pen.setWidth(0);
+    pen.setColor(item.color);
+    pen.setDashPattern(item.pattern);
+    painter.setPen(pen);
+
+    // Everything is drawn in device pixels, vertices are mapped in bulk
+    QTransform I;
+    painter.setTransform(I);
+
+    // Flatline or empty label
+    if ( !item.label.isEmpty() ) {
+        painter.drawText(item.labelPos,item.label);
+    }
+
+    // Draw curve!
+    QString lineStyle = item.lineStyle;
+    if ( lineStyle == "scatter" ) {
+        _paintSprites(item,"scatter",false,painter);
+    } else {
+        if ( lineStyle == "thick_line" ) {
+            pen.setWidth(3.0);
+        } else if ( lineStyle == "x_thick_line" ) {
+            pen.setWidthF(5.0);
+        }
+        painter.setPen(pen);
+        _paintPolyline(_devicePolyline(item),painter);
+    }
+
+    // Draw symbols on curve (if there are any)
+    QString symbolStyle = item.symbolStyle;
+    if ( !symbolStyle.isEmpty() && symbolStyle != "none" ) {
+        _paintSprites(item,symbolStyle,true,painter);
+    }
+
+    painter.restore();
+}
+
+// Curve vertices in device pixels.  Monotonic curves use the decimated
+// visible polyline, others use every path element.
+QPolygonF CurvesRenderer::_devicePolyline(const CurveRenderItem &item)
+{
+    if ( item.isMonotonic ) {
+        return item.T.map(item.pts);
+    }
+
+    const QPainterPath& path = item.path;
+    int n = path.elementCount();
+    QPolygonF poly(n);
+    for ( int i = 0; i < n; ++i ) {
+        QPainterPath::Element el = path.elementAt(i);
+        poly[i] = QPointF(el.x,el.y);
+    }
+    return item.T.map(poly);
+}
+
+// Long polylines are drawn in overlapping batches to keep the stroker's
+// working set small.  A dashed pen's pattern is carried from batch to
+// batch by its dash offset.  Wide pens are drawn in one go since their
+// caps would show at the seams.
+void CurvesRenderer::_paintPolyline(const QPolygonF &poly, QPainter &painter)
+{
+    QPen pen = painter.pen();
+    if ( pen.widthF() > 1.0 ) {
+        painter.drawPolyline(poly);
+        return;
+    }
+
+    // Pen is at most a pixel wide, so the pattern (and offset) is in pixels
+    bool isDashed = ( pen.style() != Qt::SolidLine );
+    double patternLength = 0.0;
+    if ( isDashed ) {
+        foreach ( qreal d, pen.dashPattern() ) {
+            patternLength += d;
+        }
+    }
+    double offset = pen.dashOffset();
+
+    int n = poly.size();
+    for ( int i = 0; i < n-1; i += _polylineBatchSize-1 ) {
+        int m = qMin(_polylineBatchSize,n-i);
+        if ( isDashed && i > 0 ) {
+            pen.setDashOffset(offset);
+            painter.setPen(pen);
+        }
+        painter.drawPolyline(poly.constData()+i,m);
+        if ( isDashed && patternLength > 0.0 ) {
+            for ( int k = i; k < i+m-1; ++k ) {
+                offset += QLineF(poly.at(k),poly.at(k+1)).length();
+            }
+            offset = fmod(offset,patternLength);
+        }
+    }
+}
+
+// Stamps a pre-rendered symbol (or scatter dot) at each path element.
+// Points that land on the last stamped pixel are skipped.  If
+// isDeclutter, points within 16 pixels of the last stamp are skipped too.
+void CurvesRenderer::_paintSprites(const CurveRenderItem &item,
+                                   const QString &symbol, bool isDeclutter,
+                                   QPainter &painter)
+{
+    QImage sprite = _sprite(symbol,item.color,painter.font());
+    int r = _spriteSize/2;
+
+    QRect bounds(QPoint(0,0),painter.device() ?
+                             QSize(painter.device()->width(),
+                                   painter.device()->height()) : QSize());
+    bounds.adjust(-r,-r,r,r);
+
+    const QPainterPath& path = item.path;
+    const QTransform& T = item.T;
+    QPointF pLast;
+    QPoint qLast;
+    bool isFirst = true;
+    for ( int i = 0; i < path.elementCount(); ++i ) {
+        QPainterPath::Element el = path.elementAt(i);
+        QPointF p = T.map(QPointF(el.x,el.y));
+        QPoint q(qRound(p.x()),qRound(p.y()));
+        if ( !isFirst ) {
+            if ( q == qLast ) {
+                continue;
+            }
+            if ( isDeclutter ) {
+                double d = 16.0;
+                QRectF R(pLast.x()-d,pLast.y()-d,2.0*d,2.0*d);
+                if ( R.contains(p) ) {
+                    continue;
+                }
+            }
+        }
+        if ( bounds.isEmpty() || bounds.contains(q) ) {
+            painter.drawImage(q-QPoint(r,r),sprite);
+        }
+        pLast = p;
+        qLast = q;
+        isFirst = false;
+    }
+}
+
+QImage CurvesRenderer::_sprite(const QString &symbol, const QColor &color,
+                               const QFont &font)
+{
+    QImage sprite(_spriteSize,_spriteSize,QImage::Format_ARGB32_Premultiplied);
+    sprite.fill(0);  // transparent
+
+    QPainter painter(&sprite);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setFont(font);
+    QPen pen(color);
+    QPointF c(_spriteSize/2,_spriteSize/2);
+    if ( symbol == "scatter" ) {
+        pen.setWidthF(1.5);
+        painter.setPen(pen);
+        painter.setBrush(QBrush(color,Qt::SolidPattern));
+        painter.drawEllipse(c,1.5,1.5);
+    } else {
+        pen.setWidthF(0.0);
+        painter.setPen(pen);
+        paintSymbol(c,symbol,painter);
+    }
+    painter.end();
+
+    return sprite;
+}
+
+void CurvesRenderer::paintSymbol(const QPointF& p,
+                                 const QString &symbol, QPainter &painter)
+{
+
+    QPen origPen = painter.pen();
+    QPen pen = painter.pen();
+    pen.setStyle(Qt::SolidLine);
+    painter.setPen(pen);
+
+    if ( symbol == "circle" ) {
+        painter.drawEllipse(p,2,2);
+    } else if ( symbol == "thick_circle" ) {
+        pen.setWidth(2.0);
+        painter.setPen(pen);
+        painter.drawEllipse(p,3,3);
+    } else if ( symbol == "solid_circle" ) {
+        pen.setWidthF(2.0);
+        painter.setPen(pen);
+        painter.drawEllipse(p,1,1);
+    } else if ( symbol == "square" ) {
+        double x = p.x()-2.0;
+        double y = p.y()-2.0;
+        painter.drawRect(QRectF(x,y,4,4));
+    } else if ( symbol == "thick_square") {
+        pen.setWidthF(2.0);
+        painter.setPen(pen);
+        double x = p.x()-3.0;
+        double y = p.y()-3.0;
+        painter.drawRect(QRectF(x,y,6,6));
+    } else if ( symbol == "solid_square" ) {
+        pen.setWidthF(4.0);
+        painter.setPen(pen);
+        painter.drawPoint(p); // happens to be a solid square
+    } else if ( symbol == "star" ) { // *
+        double r = 3.0;
+        QPointF a(p.x()+r*cos(18.0*M_PI/180.0),
+                  p.y()-r*sin(18.0*M_PI/180.0));
+        QPointF b(p.x(),p.y()-r);
+        QPointF c(p.x()-r*cos(18.0*M_PI/180.0),
+                  p.y()-r*sin(18.0*M_PI/180.0));
+        QPointF d(p.x()-r*cos(54.0*M_PI/180.0),
+                  p.y()+r*sin(54.0*M_PI/180.0));
+        QPointF e(p.x()+r*cos(54.0*M_PI/180.0),
+                  p.y()+r*sin(54.0*M_PI/180.0));
+        painter.drawLine(p,a);
+        painter.drawLine(p,b);
+        painter.drawLine(p,c);
+        painter.drawLine(p,d);
+        painter.drawLine(p,e);
+    } else if ( symbol == "xx" ) {
+        pen.setWidthF(2.0);
+        painter.setPen(pen);
+        QPointF a(p.x()+2.0,p.y()+2.0);
+        QPointF b(p.x()-2.0,p.y()+2.0);
+        QPointF c(p.x()-2.0,p.y()-2.0);
+        QPointF d(p.x()+2.0,p.y()-2.0);
+        painter.drawLine(p,a);
+        painter.drawLine(p,b);
+        painter.drawLine(p,c);
+        painter.drawLine(p,d);
+    } else if ( symbol == "triangle" ) {
+        double r = 3.0;
+        QPointF a(p.x(),p.y()-r);
+        QPointF b(p.x()-r*cos(30.0*M_PI/180.0),
+                  p.y()+r*sin(30.0*M_PI/180.0));
+        QPointF c(p.x()+r*cos(30.0*M_PI/180.0),
+                  p.y()+r*sin(30.0*M_PI/180.0));
+        painter.drawLine(a,b);
+        painter.drawLine(b,c);
+        painter.drawLine(c,a);
+    } else if ( symbol == "thick_triangle" ) {
+        pen.setWidthF(2.0);
+        painter.setPen(pen);
+        double r = 4.0;
+        QPointF a(p.x(),p.y()-r);
+        QPointF b(p.x()-r*cos(30.0*M_PI/180.0),
+                  p.y()+r*sin(30.0*M_PI/180.0));
+        QPointF c(p.x()+r*cos(30.0*M_PI/180.0),
+                  p.y()+r*sin(30.0*M_PI/180.0));
+        painter.drawLine(a,b);
+        painter.drawLine(b,c);
+        painter.drawLine(c,a);
+    } else if ( symbol == "solid_triangle" ) {
+        pen.setWidthF(2.0);
+        painter.setPen(pen);
+        double r = 3.0;
+        QPointF a(p.x(),p.y()-r);
+        QPointF b(p.x()-r*cos(30.0*M_PI/180.0),
+                  p.y()+r*sin(30.0*M_PI/180.0));
+        QPointF c(p.x()+r*cos(30.0*M_PI/180.0),
+                  p.y()+r*sin(30.0*M_PI/180.0));
+        painter.drawLine(a,b);
+        painter.drawLine(b,c);
+        painter.drawLine(c,a);
+    } else if ( symbol.startsWith("number_",Qt::CaseInsensitive) &&
+                symbol.size() == 8 ) {
+
+        QFont origFont = painter.font();
+        QBrush origBrush = painter.brush();
+
+        // Calculate bbox to draw text in
+        QString number = symbol.right(1); // last char is '0'-'9'
+        QFont font = painter.font();
+        font.setPointSize(7);
+        painter.setFont(font);
+        QFontMetrics fm = painter.fontMetrics();
+        QRectF bbox(fm.tightBoundingRect(number));
+        bbox.moveCenter(p);
+
+        // Draw solid circle around number
+        QRectF box(bbox);
+        double l = 3.0*qMax(box.width(),box.height())/2.0;
+        box.setWidth(l);
+        box.setHeight(l);
+        box.moveCenter(p);
+        QBrush brush(pen.color());
+        painter.setBrush(brush);
+        painter.drawEllipse(box);
+
+        // Draw number in white in middle of circle
+        QPen whitePen("white");
+        painter.setPen(whitePen);
+        painter.drawText(bbox,Qt::AlignCenter,number);
+
+        painter.setFont(origFont);
+        painter.setBrush(origBrush);
+    }
+
+    painter.setPen(origPen);
+}
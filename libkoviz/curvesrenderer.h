@@ -0,0 +1,115 @@
+#ifndef CURVESRENDERER_H
+#define CURVESRENDERER_H
+
+#include <QObject>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QTransform>
+#include <QColor>
+#include <QFont>
+#include <QVector>
+#include <QList>
+#include <QString>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QRegion>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+
+// What is needed to paint one curve, copied out of the book model on the
+// GUI thread so that it can be painted on any thread
+class CurveRenderItem
+{
+  public:
+    CurveRenderItem() : isMonotonic(false) {}
+
+    QPainterPath path;        // shares the model's path data (copy on write)
+    QPolygonF pts;            // decimated visible part if isMonotonic
+    bool isMonotonic;
+    QTransform T;             // math to pixel, includes curve scale/bias
+    QColor color;
+    QVector<qreal> pattern;
+    QString lineStyle;
+    QString symbolStyle;
+    QString label;            // e.g. "Flatline=3" drawn at labelPos (pixels)
+    QPointF labelPos;
+};
+
+class CurvesRenderJob
+{
+  public:
+    QSize size;
+    QTransform T;             // plot math to pixel transform of the image
+    QFont font;
+    QList<CurveRenderItem> items;
+
+    // When panning, base (the last image) is copied in at baseOffset and
+    // only the exposed region is painted
+    QImage base;
+    QPoint baseOffset;
+    QRegion exposed;
+};
+
+class CurvesRenderer;
+
+// Shared by a renderer and its tasks, which may still be queued in the
+// pool after the renderer is deleted
+class CurvesRenderState
+{
+  public:
+    CurvesRenderState(CurvesRenderer* r) : renderer(r), generation(0) {}
+
+    QMutex mutex;               // guards renderer
+    CurvesRenderer* renderer;   // 0 once the renderer is deleted
+    QAtomicInt generation;
+};
+
+// Paints a plot's curves into a transparent QImage on a worker thread
+//
+// Each render() starts a new generation.  A job that sees a newer
+// generation stops between curves and its image is dropped, so only the
+// latest job's image is handed out via rendered().  All renderers (all
+// plots in the book) share one pool of render threads.
+class CurvesRenderer : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit CurvesRenderer(QObject* parent = 0);
+    ~CurvesRenderer();
+
+    void render(const CurvesRenderJob& job);
+    void cancel();
+
+    static void paintCurve(const CurveRenderItem& item, QPainter& painter);
+    static void paintSymbol(const QPointF& p, const QString& symbol,
+                            QPainter& painter);
+
+  signals:
+    void rendered(const QImage& image, const QTransform& T);
+
+  private slots:
+    void _jobDone(const QImage& image, const QTransform& T, int generation);
+
+  private:
+    QSharedPointer<CurvesRenderState> _state;
+
+    static QThreadPool* _pool();
+
+    static QPolygonF _devicePolyline(const CurveRenderItem& item);
+    static void _paintPolyline(const QPolygonF& poly, QPainter& painter);
+    static void _paintSprites(const CurveRenderItem& item,
+                              const QString& symbol, bool isDeclutter,
+                              QPainter& painter);
+    static QImage _sprite(const QString& symbol, const QColor& color,
+                          const QFont& font);
+
+    static const int _polylineBatchSize = 4096;
+    static const int _spriteSize = 32;
+};
+
+#endif // CURVESRENDERER_H
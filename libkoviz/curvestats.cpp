@@ -0,0 +1,321 @@
+#include "curvestats.h"
+#include <QHash>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <qnumeric.h>
+#include <algorithm>
+#include <cmath>
+
+static const int _timesPerTask = 4096;
+static const qint64 _maxMatrixSize = 1<<24;  // doubles per slice (128MB)
+
+//
+// Pool tasks
+//
+
+// Matches the curves of one data file to a slice of the time grid and
+// writes their y (or NaN if unmatched) into their matrix columns
+class CurveStatsAligner : public QRunnable
+{
+  public:
+    CurveStatsAligner(const QList<CurveStatsInput>& inputs,
+                      const QList<int>& cols,
+                      const double* times, int nTimes,
+                      double tolerance, double* matrix, int nCols) :
+        _inputs(inputs), _cols(cols), _times(times), _nTimes(nTimes),
+        _tolerance(tolerance), _matrix(matrix), _nCols(nCols) {}
+
+    void run()
+    {
+        // Curves of a file share its data model, so map it once
+        _inputs.at(0).curve->map();
+        for ( int k = 0; k < _inputs.size(); ++k ) {
+            _align(_inputs.at(k),_cols.at(k));
+        }
+        _inputs.at(0).curve->unmap();
+    }
+
+  private:
+    QList<CurveStatsInput> _inputs;
+    QList<int> _cols;
+    const double* _times;
+    int _nTimes;
+    double _tolerance;
+    double* _matrix;
+    int _nCols;
+
+    void _align(const CurveStatsInput& in, int col);
+    int _lowerBound(const CurveStatsInput& in, int rc, double time) const;
+};
+
+void CurveStatsAligner::_align(const CurveStatsInput &in, int col)
+{
+    // Only read the rows that can match the slice
+    int rc = in.curve->rowCount();
+    int row0 = _lowerBound(in,rc,_times[0]-_tolerance);
+    int row1 = _lowerBound(in,rc,_times[_nTimes-1]+_tolerance);
+    if ( row1 < rc ) {
+        ++row1;  // row at end time+tolerance is still a match
+    }
+    int n = row1-row0;
+    QVector<double> ts(n);
+    QVector<double> ys(n);
+    if ( n > 0 ) {
+        in.curve->fill(row0,row1,ts.data(),0,ys.data());
+    }
+
+    int j = 0;
+    for ( int i = 0; i < _nTimes; ++i ) {
+        double y = qQNaN();
+        if ( n > 0 ) {
+            double t = _times[i];
+            while ( j+1 < n &&
+                    qAbs(in.xs*ts.at(j+1)+in.xb-t) <=
+                    qAbs(in.xs*ts.at(j)+in.xb-t) ) {
+                ++j;
+            }
+            if ( qAbs(in.xs*ts.at(j)+in.xb-t) <= _tolerance ) {
+                y = in.ys*ys.at(j)+in.yb;
+            }
+        }
+        _matrix[(qint64)i*_nCols+col] = y;
+    }
+}
+
+// First row whose scaled time is >= time (one row fill per probe)
+int CurveStatsAligner::_lowerBound(const CurveStatsInput& in, int rc,
+                                   double time) const
+{
+    int lo = 0;
+    int hi = rc;
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        double t;
+        in.curve->fill(mid,mid+1,&t,0,0);
+        if ( in.xs*t+in.xb < time ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Reduces matrix rows [i0,i1) to statistics
+class CurveStatsReducer : public QRunnable
+{
+  public:
+    CurveStatsReducer(const double* matrix, int nCols, int i0, int i1,
+                      double** stats, int* nSamples) :
+        _matrix(matrix), _nCols(nCols), _i0(i0), _i1(i1),
+        _stats(stats), _nSamples(nSamples) {}
+
+    void run()
+    {
+        QVector<double> vals(_nCols);
+        for ( int i = _i0; i < _i1; ++i ) {
+            const double* row = _matrix+(qint64)i*_nCols;
+            int n = 0;
+            for ( int k = 0; k < _nCols; ++k ) {
+                if ( !qIsNaN(row[k]) ) {
+                    vals[n++] = row[k];
+                }
+            }
+            _nSamples[i] = n;
+            if ( n == 0 ) {
+                for ( int s = 0; s < CurveStats::NumStats; ++s ) {
+                    _stats[s][i] = qQNaN();
+                }
+                continue;
+            }
+
+            double sum = 0.0;
+            double min = vals.at(0);
+            double max = vals.at(0);
+            for ( int k = 0; k < n; ++k ) {
+                sum += vals.at(k);
+                min = qMin(min,vals.at(k));
+                max = qMax(max,vals.at(k));
+            }
+            double mean = sum/n;
+            double ss = 0.0;
+            for ( int k = 0; k < n; ++k ) {
+                double d = vals.at(k)-mean;
+                ss += d*d;
+            }
+
+            _stats[CurveStats::Mean][i] = mean;
+            _stats[CurveStats::StdDev][i] = ( n > 1 ) ? sqrt(ss/(n-1)) : 0.0;
+            _stats[CurveStats::Min][i] = min;
+            _stats[CurveStats::Max][i] = max;
+            double* v = vals.data();
+            _stats[CurveStats::P5][i] = _percentile(v,n,0.05);
+            _stats[CurveStats::P50][i] = _percentile(v,n,0.50);
+            _stats[CurveStats::P95][i] = _percentile(v,n,0.95);
+        }
+    }
+
+  private:
+    const double* _matrix;
+    int _nCols;
+    int _i0;
+    int _i1;
+    double** _stats;
+    int* _nSamples;
+
+    // Linearly interpolated between closest ranks (reorders v)
+    static double _percentile(double* v, int n, double p)
+    {
+        double pos = p*(n-1);
+        int k = (int)floor(pos);
+        std::nth_element(v,v+k,v+n);
+        double lo = v[k];
+        if ( k+1 >= n || pos == k ) {
+            return lo;
+        }
+        double hi = *std::min_element(v+k+1,v+n);
+        return lo+(pos-k)*(hi-lo);
+    }
+};
+
+CurveStats::CurveStats(const QList<CurveStatsInput> &inputs,
+                       double start, double stop, double tolerance) :
+    _nCurves(inputs.size())
+{
+    if ( inputs.isEmpty() ) {
+        return;
+    }
+
+    // Time grid is the timestamps of the curve that spans the most of
+    // [start,stop], so runs that start late or stop early don't cut it
+    const CurveStatsInput& in0 = inputs.at(_longestCurve(inputs,start,stop));
+    in0.curve->map();
+    int rc = in0.curve->rowCount();
+    QVector<double> ts(rc);
+    if ( rc > 0 ) {
+        in0.curve->fill(0,rc,ts.data(),0,0);
+    }
+    in0.curve->unmap();
+    foreach ( double t, ts ) {
+        t = in0.xs*t+in0.xb;
+        if ( t >= start && t <= stop ) {
+            _times.append(t);
+        }
+    }
+
+    int nTimes = _times.size();
+    for ( int s = 0; s < NumStats; ++s ) {
+        _stats[s].resize(nTimes);
+    }
+    _nSamples.resize(nTimes);
+    if ( nTimes == 0 ) {
+        return;
+    }
+
+    // Curves from the same file go in the same task since they share
+    // a data model
+    QHash<QString,int> file2group;
+    QList<QList<CurveStatsInput> > groups;
+    QList<QList<int> > groupCols;
+    for ( int k = 0; k < _nCurves; ++k ) {
+        QString fileName = inputs.at(k).curve->fileName();
+        if ( !file2group.contains(fileName) ) {
+            file2group.insert(fileName,groups.size());
+            groups.append(QList<CurveStatsInput>());
+            groupCols.append(QList<int>());
+        }
+        int g = file2group.value(fileName);
+        groups[g].append(inputs.at(k));
+        groupCols[g].append(k);
+    }
+
+    double* stats[NumStats];
+    for ( int s = 0; s < NumStats; ++s ) {
+        stats[s] = _stats[s].data();
+    }
+
+    int sliceSize = (int)qMax((qint64)1,_maxMatrixSize/_nCurves);
+    sliceSize = qMin(sliceSize,nTimes);
+    QVector<double> matrix(sliceSize*_nCurves);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(QThread::idealThreadCount(),1));
+    for ( int i0 = 0; i0 < nTimes; i0 += sliceSize ) {
+        int n = qMin(sliceSize,nTimes-i0);
+        for ( int g = 0; g < groups.size(); ++g ) {
+            pool.start(new CurveStatsAligner(groups.at(g),groupCols.at(g),
+                                             _times.constData()+i0,n,
+                                             tolerance,matrix.data(),
+                                             _nCurves));
+        }
+        pool.waitForDone();
+
+        // Reducers index the slice from 0, so offset the outputs
+        double* sliceStats[NumStats];
+        for ( int s = 0; s < NumStats; ++s ) {
+            sliceStats[s] = stats[s]+i0;
+        }
+        for ( int j0 = 0; j0 < n; j0 += _timesPerTask ) {
+            int j1 = qMin(j0+_timesPerTask,n);
+            pool.start(new CurveStatsReducer(matrix.constData(),_nCurves,
+                                             j0,j1,sliceStats,
+                                             _nSamples.data()+i0));
+        }
+        pool.waitForDone();
+    }
+}
+
+// Index of the input whose scaled time span overlaps [start,stop] the
+// most (the one with more rows on a tie)
+int CurveStats::_longestCurve(const QList<CurveStatsInput> &inputs,
+                              double start, double stop)
+{
+    int longest = 0;
+    double longestSpan = -1.0;
+    int longestRows = 0;
+    for ( int k = 0; k < inputs.size(); ++k ) {
+        const CurveStatsInput& in = inputs.at(k);
+        in.curve->map();
+        int rc = in.curve->rowCount();
+        if ( rc > 0 ) {
+            double t0;
+            double t1;
+            in.curve->fill(0,1,&t0,0,0);
+            in.curve->fill(rc-1,rc,&t1,0,0);
+            t0 = in.xs*t0+in.xb;
+            t1 = in.xs*t1+in.xb;
+            double span = qMin(qMax(t0,t1),stop)-qMax(qMin(t0,t1),start);
+            if ( span > longestSpan ||
+                 (span == longestSpan && rc > longestRows) ) {
+                longest = k;
+                longestSpan = span;
+                longestRows = rc;
+            }
+        }
+        in.curve->unmap();
+    }
+    return longest;
+}
+
+double CurveStats::bandValue(Band band, int i) const
+{
+    double v = qQNaN();
+    switch ( band ) {
+    case BandMin:  v = _stats[Min].at(i); break;
+    case BandP5:   v = _stats[P5].at(i); break;
+    case BandP50:  v = _stats[P50].at(i); break;
+    case BandMean: v = _stats[Mean].at(i); break;
+    case BandP95:  v = _stats[P95].at(i); break;
+    case BandMax:  v = _stats[Max].at(i); break;
+    case BandMeanMinusSigma:
+        v = _stats[Mean].at(i)-_stats[StdDev].at(i);
+        break;
+    case BandMeanPlusSigma:
+        v = _stats[Mean].at(i)+_stats[StdDev].at(i);
+        break;
+    default:
+        break;
+    }
+    return v;
+}
@@ -0,0 +1,61 @@
+#ifndef CURVESTATS_H
+#define CURVESTATS_H
+
+#include <QList>
+#include <QVector>
+#include "curvemodel.h"
+
+// A curve of a statistics plot and the scale/bias that takes its
+// logged time and y to plot units
+class CurveStatsInput
+{
+  public:
+    CurveModel* curve;
+    double xs;
+    double xb;
+    double ys;
+    double yb;
+};
+
+// Time aligned statistics over many curves of one variable, e.g. a
+// variable over all runs of a Monte Carlo set
+//
+// The timestamps within [start,stop] of the curve spanning the most of
+// it are the time grid.  Each curve is matched to the grid (nearest
+// timestamp within tolerance) by pool threads, one task per data file,
+// into a matrix.  Then the grid is cut into chunks and each chunk's mean,
+// standard deviation, min, max and 5/50/95th percentiles are computed
+// over the curves that have a sample there.  Long grids are done in
+// slices so the matrix stays bounded.  Curve times must ascend.
+class CurveStats
+{
+  public:
+    enum Stat { Mean, StdDev, Min, Max, P5, P50, P95, NumStats };
+
+    // Curves drawn for the statistics (the deviation as mean+/-sigma)
+    enum Band { BandMin, BandP5, BandP50, BandMean, BandP95, BandMax,
+                BandMeanMinusSigma, BandMeanPlusSigma, NumBands };
+
+    CurveStats(const QList<CurveStatsInput>& inputs,
+               double start, double stop, double tolerance);
+
+    int count() const { return _times.size(); }
+    int curveCount() const { return _nCurves; }
+    const QVector<double>& times() const { return _times; }
+    const QVector<double>& stat(Stat s) const { return _stats[s]; }
+    int sampleCount(int i) const { return _nSamples.at(i); }
+
+    // NaN where no curve has a sample at time i
+    double bandValue(Band band, int i) const;
+
+  private:
+    int _nCurves;
+    QVector<double> _times;
+    QVector<double> _stats[NumStats];
+    QVector<int> _nSamples;       // curves matched at each grid time
+
+    static int _longestCurve(const QList<CurveStatsInput>& inputs,
+                             double start, double stop);
+};
+
+#endif // CURVESTATS_H
@@ -0,0 +1,163 @@
+#include "curvetimeindex.h"
+
+QHash<CurveTimeIndex::Key,CurveTimeIndex*> CurveTimeIndex::_cache;
+QMutex CurveTimeIndex::_cacheMutex;
+
+CurveTimeIndex* CurveTimeIndex::acquire(CurveModel *curveModel)
+{
+    Key key(curveModel->dataModel(),curveModel->tcol());
+
+    _cacheMutex.lock();
+    CurveTimeIndex* timeIndex = _cache.value(key,0);
+    if ( timeIndex ) {
+        ++timeIndex->_refCount;
+        _cacheMutex.unlock();
+        return timeIndex;
+    }
+    _cacheMutex.unlock();
+
+    // Built outside of the lock, so another thread may beat this one to
+    // it, in which case its index is used instead
+    curveModel->map();
+    CurveTimeIndex* newTimeIndex = new CurveTimeIndex(curveModel);
+    curveModel->unmap();
+
+    QMutexLocker locker(&_cacheMutex);
+    timeIndex = _cache.value(key,0);
+    if ( timeIndex ) {
+        delete newTimeIndex;
+    } else {
+        timeIndex = newTimeIndex;
+        timeIndex->_key = key;
+        _cache.insert(key,timeIndex);
+    }
+    ++timeIndex->_refCount;
+
+    return timeIndex;
+}
+
+void CurveTimeIndex::release(CurveTimeIndex *timeIndex)
+{
+    if ( !timeIndex ) {
+        return;
+    }
+
+    QMutexLocker locker(&_cacheMutex);
+    if ( --timeIndex->_refCount == 0 ) {
+        _cache.remove(timeIndex->_key);
+        delete timeIndex;
+    }
+}
+
+CurveTimeIndex::CurveTimeIndex(const CurveModel *curveModel) :
+    _refCount(0),
+    _isMonotonic(true)
+{
+    int rc = curveModel->rowCount();
+    _times.resize(rc);
+    if ( rc > 0 ) {
+        curveModel->fill(0,rc,_times.data(),0,0);
+    }
+
+    for ( int i = 0; i < rc; ++i ) {
+        if ( i == 0 || _times.at(i) != _times.at(i-1) ) {
+            _runBegs.append(i);
+        }
+        if ( i > 0 && _times.at(i) < _times.at(i-1) ) {
+            _isMonotonic = false;
+        }
+    }
+}
+
+int CurveTimeIndex::indexAtTime(double time) const
+{
+    int i = upperBound(time);
+    if ( i == 0 ) {
+        return 0;
+    }
+    return runBegin(i-1);
+}
+
+int CurveTimeIndex::lowerBound(double time) const
+{
+    int lo = 0;
+    int hi = _times.size();
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( _times.at(mid) < time ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int CurveTimeIndex::upperBound(double time) const
+{
+    int lo = 0;
+    int hi = _times.size();
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( _times.at(mid) <= time ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int CurveTimeIndex::runBegin(int i) const
+{
+    return _runBegs.at(_run(i));
+}
+
+int CurveTimeIndex::runEnd(int i) const
+{
+    int r = _run(i)+1;
+    return ( r < _runBegs.size() ) ? _runBegs.at(r) : _times.size();
+}
+
+// Run containing row i (last run beginning at or before i)
+int CurveTimeIndex::_run(int i) const
+{
+    int lo = 0;
+    int hi = _runBegs.size();
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( _runBegs.at(mid) <= i ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+    return qMax(lo-1,0);
+}
+
+int CurveTimeIndex::pathIndexAtTime(const QPainterPath *path, double time)
+{
+    int n = path->elementCount();
+    int lo = 0;
+    int hi = n;
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( path->elementAt(mid).x <= time ) {
+            lo = mid+1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if ( lo == 0 ) {
+        return 0;
+    }
+
+    // Timestamps may duplicate, go to first in series
+    int i = lo-1;
+    double iTime = path->elementAt(i).x;
+    while ( i > 0 && path->elementAt(i-1).x == iTime ) {
+        --i;
+    }
+    return i;
+}
@@ -0,0 +1,63 @@
+#ifndef CURVETIMEINDEX_H
+#define CURVETIMEINDEX_H
+
+#include <QPainterPath>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QMutexLocker>
+#include "curvemodel.h"
+
+// Copy of a curve's timestamps (in logged order) with duplicate runs
+//
+// Built once per data model time column, and shared by the curves that
+// use it, so that live time lookups are binary searches that neither
+// map the curve's data nor walk its iterator.  Rows that share a
+// timestamp (e.g. several points logged in one frame) form a run, and
+// runBegin()/runEnd() give the run of any row.
+class CurveTimeIndex
+{
+public:
+    // Index of curveModel's time column (built if not shared yet, with
+    // the curve mapped).  Each acquire() is paired with a release().
+    static CurveTimeIndex* acquire(CurveModel* curveModel);
+    static void release(CurveTimeIndex* timeIndex);  // ok if 0
+
+    int count() const { return _times.size(); }
+    double time(int i) const { return _times.at(i); }
+
+    // False if time ever steps backwards (then lookups are unreliable)
+    bool isMonotonic() const { return _isMonotonic; }
+
+    int lowerBound(double time) const;  // first row with t >= time
+    int upperBound(double time) const;  // first row with t > time
+
+    // First row of the last run at or before time (0 if time precedes
+    // the first timestamp)
+    int indexAtTime(double time) const;
+
+    int runBegin(int i) const;
+    int runEnd(int i) const;      // one past the last row of i's run
+
+    // Same lookup on a painter path whose x is time
+    static int pathIndexAtTime(const QPainterPath* path, double time);
+
+private:
+    typedef QPair<const DataModel*,int> Key;   // data model, time column
+
+    CurveTimeIndex(const CurveModel* curveModel);  // curve must be mapped
+
+    Key _key;
+    int _refCount;                // guarded by _cacheMutex
+    QVector<double> _times;
+    QVector<int> _runBegs;        // first row of each run, ascending
+    bool _isMonotonic;
+
+    int _run(int i) const;
+
+    static QHash<Key,CurveTimeIndex*> _cache;
+    static QMutex _cacheMutex;
+};
+
+#endif // CURVETIMEINDEX_H
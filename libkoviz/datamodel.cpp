@@ -1,4 +1,5 @@
 #include <QFileInfo>
+#include <stdexcept>
 #include "datamodel.h"
 #include "datamodel_trick.h"
 #include "datamodel_csv.h"
@@ -16,10 +17,27 @@ DataModel *DataModel::createDataModel(const QStringList &timeNames,
     } else if ( fi.suffix() == "mot" ) {
         dataModel = new MotModel(timeNames,fileName);
     } else {
-        fprintf(stderr,"koviz [error]: DataModel::createDataModel() cannot "
-                       "handle file=\"%s\"\n",fileName.toLatin1().constData());
-        exit(-1);
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: DataModel::createDataModel() cannot "
+            << "handle file=\"" << fileName << "\"\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
     return dataModel;
 }
+
+// Generic version walks an iterator, models override with a direct copy
+void DataModel::fill(int tcol, int xcol, int ycol, int row0, int row1,
+                     double *t, double *x, double *y) const
+{
+    ModelIterator* it = begin(tcol,xcol,ycol);
+    it->at(row0);
+    for ( int i = 0; i < row1-row0; ++i ) {
+        if ( t ) t[i] = it->t();
+        if ( x ) x[i] = it->x();
+        if ( y ) y[i] = it->y();
+        it->next();
+    }
+    delete it;
+}
@@ -41,6 +41,11 @@ class DataModel : public QAbstractTableModel
     virtual ModelIterator* begin(int tcol, int xcol, int ycol) const = 0;
     virtual int indexAtTime(double time) = 0 ;
 
+    // Copies rows [row0,row1) of tcol, xcol and ycol into t, x and y
+    // (a null buffer is skipped).  Use between map() and unmap().
+    virtual void fill(int tcol, int xcol, int ycol, int row0, int row1,
+                      double* t, double* x, double* y) const;
+
     virtual int rowCount(const QModelIndex& pidx=QModelIndex()) const = 0;
     virtual int columnCount(const QModelIndex& pidx=QModelIndex()) const = 0;
     virtual QVariant data(const QModelIndex& idx,
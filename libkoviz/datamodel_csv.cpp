@@ -9,24 +9,46 @@ CsvModel::CsvModel(const QStringList& timeNames,
     DataModel(timeNames, csvfile, parent),
     _timeNames(timeNames),_csvfile(csvfile),
     _nrows(0), _ncols(0),_iteratorTimeIndex(0),
-    _data(0)
+    _data(0),
+    _mem(0), _parser(0), _columnCache(0), _sidecar(0),
+    _isColumnMajor(false), _sidecarWriter(0)
 {
     _init();
 }
 
 void CsvModel::_init()
 {
-    QFile file(_csvfile);
+    _file.setFileName(_csvfile);
 
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!_file.open(QIODevice::ReadOnly)) {
         _err_stream << "koviz [error]: could not open "
                     << _csvfile << "\n";
         throw std::runtime_error(_err_string.toLatin1().constData());
     }
-    QTextStream in(&file);
-    in.setCodec("UTF-8");
 
-    QString line0 = in.readLine();
+    // Parse straight from the mapped file (no QTextStream/QString per field)
+    qint64 size = _file.size();
+    const char* mem = 0;
+    if ( size > 0 ) {
+        mem = (const char*) _file.map(0,size);
+        _mem = mem;
+        if ( !mem ) {
+            _err_stream << "koviz [error]: CsvModel couldn't map file: "
+                        << _csvfile << "\n";
+            throw std::runtime_error(_err_string.toLatin1().constData());
+        }
+    }
+
+    // Header line
+    qint64 hend = 0;
+    if ( mem ) {
+        const char* nl = (const char*) memchr(mem,'\n',size);
+        hend = nl ? nl-mem : size;
+    }
+    QString line0 = QString::fromUtf8(mem,hend);
+    if ( line0.endsWith('\r') ) {
+        line0.chop(1);
+    }
     QStringList items = line0.split(',',QString::SkipEmptyParts);
     int col = 0;
     foreach ( QString item, items ) {
@@ -82,74 +104,88 @@ void CsvModel::_init()
         throw std::runtime_error(_err_string.toLatin1().constData());
     }
 
-    _iteratorTimeIndex = new CsvModelIterator(0,this,
-                                              _timeCol,_timeCol,_timeCol);
+    // Map the binary copy written by an earlier parse of the unchanged
+    // log (column-major for wide logs since they're used a column at a time)
+    bool isLazy = TextLogColumnCache::isLazy(_ncols);
+    _sidecar = new TextLogSidecar(_csvfile);
+    TextLogSidecar::Layout layout = isLazy ? TextLogSidecar::ColumnMajor
+                                           : TextLogSidecar::RowMajor;
+    const double* sidecarData = _sidecar->map(_ncols,&_nrows,layout);
+    if ( sidecarData ) {
+        _data = (double*)sidecarData;
+        _isColumnMajor = isLazy;
+        if ( mem ) {
+            _file.unmap((uchar*)mem);
+            _mem = 0;
+        }
+        _file.close();
+    } else {
+        delete _sidecar;
+        _sidecar = 0;
 
-#ifdef __linux
-    TimeItLinux timer;
-    timer.start();
-#endif
+        // Find data rows (in parallel)
+        qint64 dataBeg = qMin(hend+1,size);
+        _parser = new TextLogParser(mem,dataBeg,size,',',&CsvModel::_convert);
+        _nrows = _parser->rowCount();
 
-    // Get number of data rows in csv file
-    while ( !in.atEnd() ) {
-        in.readLine();
-        ++_nrows;
-    }
+        if ( isLazy ) {
+            // Wide log - keep file mapped and parse columns when first used
+            _columnCache = new TextLogColumnCache(_parser);
 
-    // Allocate to hold *all* parsed data
-    _data = (double*)malloc(_nrows*_ncols*sizeof(double));
-
-    // Begin Progress Dialog
-    QString msg("Loading ");
-    msg += QFileInfo(fileName()).fileName();
-    msg += "...";
-    QProgressDialog progress(msg, "Abort", 0, _nrows-1, 0);
-    progress.setWindowModality(Qt::WindowModal);
-    int row = 0;
-
-    // Read in data
-    in.seek(0);
-    in.readLine(); // csv header line
-    int i = 0;
-    while ( !in.atEnd() ) {
-        if (progress.wasCanceled()) {
-             break;
-        }
-        if ( row % 10000 == 0 ) {
-            progress.setValue(row);
-        }
-        ++row;
-
-        QString line = in.readLine();
-        int from = 0;
-        while (1) {
-            int j = line.indexOf(',',from);
-            if ( j < 0 ) {
-                _data[i] = _convert(line.mid(from,line.size()-from));
-                ++i;
-                break;
+            // Meanwhile write the binary copy for the next open
+            _sidecarWriter = new TextLogSidecar(_csvfile);
+            _sidecarWriter->writeColumns(_parser,_ncols);
+        } else {
+            // Allocate to hold *all* parsed data
+            _data = (double*)malloc((qint64)_nrows*_ncols*sizeof(double));
+
+            // Parse data (in parallel) with progress dialog
+            QString msg("Loading ");
+            msg += QFileInfo(fileName()).fileName();
+            msg += "...";
+            QProgressDialog progress(msg, "Abort", 0, _nrows, 0);
+            progress.setWindowModality(Qt::WindowModal);
+            _nrows = _parser->parseRows(_data,_ncols,&progress);
+            progress.setValue(progress.maximum());
+
+            // Next open of the (unchanged) log maps a binary copy instead
+            if ( _nrows == _parser->rowCount() ) {
+                TextLogSidecar(_csvfile).write(_data,_nrows,_ncols);
             }
-            _data[i] = _convert(line.mid(from,j-from));
-            from = j+1;
-            ++i;
-        }
 
-#ifdef __linux
-        if ( row % 10000 == 0 ) {
-            int secs = qRound(timer.stop()/1000000.0);
-            div_t d = div(secs,60);
-            QString msg = QString("Loaded %1 of %2 lines "
-                                  "(%3 min %4 sec)")
-                    .arg(row).arg(_nrows).arg(d.quot).arg(d.rem);
-            progress.setLabelText(msg);
+            delete _parser;
+            _parser = 0;
+            if ( mem ) {
+                _file.unmap((uchar*)mem);
+                _mem = 0;
+            }
+            _file.close();
         }
-#endif
     }
 
-    // End Progress Dialog
-    progress.setValue(_nrows-1);
+    _iteratorTimeIndex = new CsvModelIterator(0,this,
+                                              _timeCol,_timeCol,_timeCol);
+}
 
-    file.close();
+const double* CsvModel::_pinColumn(int col, int *stride) const
+{
+    if ( _columnCache ) {
+        *stride = 1;
+        return _columnCache->pin(col);
+    }
+    if ( _isColumnMajor ) {
+        *stride = 1;
+        return _data+(qint64)col*_nrows;
+    }
+    *stride = _ncols;
+    return _data+col;
+}
+
+void CsvModel::_unpinColumn(int col) const
+{
+    if ( _columnCache ) {
+        _columnCache->unpin(col);
+    }
 }
 
 void CsvModel::map()
@@ -170,11 +206,48 @@ ModelIterator *CsvModel::begin(int tcol, int xcol, int ycol) const
     return new CsvModelIterator(0,this,tcol,xcol,ycol);
 }
 
+void CsvModel::fill(int tcol, int xcol, int ycol, int row0, int row1,
+                    double *t, double *x, double *y) const
+{
+    _fillColumn(tcol,row0,row1,t);
+    _fillColumn(xcol,row0,row1,x);
+    _fillColumn(ycol,row0,row1,y);
+}
+
+void CsvModel::_fillColumn(int col, int row0, int row1, double *out) const
+{
+    if ( !out ) {
+        return;
+    }
+    int stride;
+    const double* v = _pinColumn(col,&stride);
+    if ( stride == 1 ) {
+        memcpy(out,v+row0,(row1-row0)*sizeof(double));
+    } else {
+        const double* p = v+(qint64)row0*stride;
+        for ( int i = row0; i < row1; ++i ) {
+            *out++ = *p;
+            p += stride;
+        }
+    }
+    _unpinColumn(col);
+}
+
 CsvModel::~CsvModel()
 {
+    if ( _sidecarWriter ) {
+        // Stops the write (it reads the parser and mapped log)
+        delete _sidecarWriter;
+        _sidecarWriter = 0;
+    }
     foreach ( Parameter* param, _col2param.values() ) {
         delete param;
     }
+    if ( _sidecar ) {
+        delete _sidecar;
+        _sidecar = 0;
+        _data = 0;
+    }
     if ( _data ) {
         free(_data);
         _data = 0;
@@ -184,6 +257,18 @@ CsvModel::~CsvModel()
         delete _iteratorTimeIndex;
         _iteratorTimeIndex = 0;
     }
+    if ( _columnCache ) {
+        delete _columnCache;
+        _columnCache = 0;
+    }
+    if ( _parser ) {
+        delete _parser;
+        _parser = 0;
+    }
+    if ( _mem ) {
+        _file.unmap((uchar*)_mem);
+        _mem = 0;
+    }
 }
 
 const Parameter* CsvModel::param(int col) const
@@ -268,7 +353,13 @@ QVariant CsvModel::data(const QModelIndex &idx, int role) const
     if ( idx.isValid() && _data ) {
         int row = idx.row();
         int col = idx.column();
-        val = _data[row*_ncols+col];
+        if ( _isColumnMajor ) {
+            val = _data[(qint64)col*_nrows+row];
+        } else {
+            val = _data[(qint64)row*_ncols+col];
+        }
+    } else if ( idx.isValid() && _columnCache ) {
+        val = _columnCache->value(idx.row(),idx.column());
     }
 
     return val;
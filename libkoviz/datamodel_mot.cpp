@@ -1,7 +1,5 @@
 #include "datamodel_mot.h"
 
-QString MotModel::_err_string;
-QTextStream MotModel::_err_stream(&MotModel::_err_string);
 
 MotModel::MotModel(const QStringList& timeNames,
                    const QString& motfile,
@@ -9,51 +7,74 @@ MotModel::MotModel(const QStringList& timeNames,
     DataModel(timeNames, motfile, parent),
     _timeNames(timeNames),_motfile(motfile),
     _nrows(0), _ncols(0),_iteratorTimeIndex(0),
-    _data(0)
+    _data(0),
+    _mem(0), _parser(0), _columnCache(0), _sidecar(0),
+    _isColumnMajor(false), _sidecarWriter(0)
 {
     _init();
 }
 
 void MotModel::_init()
 {
-    QFile file(_motfile);
+    _file.setFileName(_motfile);
+
+    if (!_file.open(QIODevice::ReadOnly)) {
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: could not open "
+            << _motfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
+    }
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        _err_stream << "koviz [error]: could not open "
-                    << _motfile << "\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+    // Parse straight from the mapped file
+    qint64 size = _file.size();
+    const char* mem = 0;
+    if ( size > 0 ) {
+        mem = (const char*) _file.map(0,size);
+        if ( !mem ) {
+            QString msg;
+            QTextStream err(&msg);
+            err << "koviz [error]: MotModel couldn't map file: "
+                << _motfile << "\n";
+            throw std::runtime_error(msg.toLatin1().constData());
+        }
+        _mem = mem;
     }
-    QTextStream in(&file);
-    in.setCodec("UTF-8");
 
     // Header - skip until line with variables
     bool isEndHeader = false;
-    QString line;
-    while ( 1 ) {
-        line = in.readLine();
-        if ( line.isNull() ) {
-            break;
-        }
+    qint64 pos = 0;
+    while ( pos < size ) {
+        const char* nl = (const char*) memchr(mem+pos,'\n',size-pos);
+        qint64 eol = nl ? nl-mem : size;
+        QByteArray line = QByteArray::fromRawData(mem+pos,eol-pos);
+        pos = qMin(eol+1,size);
         if ( line.contains("endheader") ) {
             isEndHeader = true;
             break;
         }
     }
     if ( !isEndHeader ) {
-        fprintf(stderr, "koviz [error]: \"endheader\" not found in file=%s\n",
-                _motfile.toLatin1().constData());
-        exit(-1);
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: \"endheader\" not found in file="
+            << _motfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
-
     // Read in variables
-    line = in.readLine();
-    if ( line.isNull() ) {
+    if ( pos >= size ) {
         // No param list!
-        fprintf(stderr, "koviz [error]: malformed *.mot file=%s\n",
-                _motfile.toLatin1().constData());
-        exit(-1);
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: malformed *.mot file="
+            << _motfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
+    const char* nl = (const char*) memchr(mem+pos,'\n',size-pos);
+    qint64 eol = nl ? nl-mem : size;
+    QString line = QString::fromUtf8(mem+pos,eol-pos);
+    pos = qMin(eol+1,size);
     QStringList items = line.split('\t',QString::SkipEmptyParts);
     int col = 0;
     foreach ( QString item, items ) {
@@ -75,64 +96,97 @@ void MotModel::_init()
     _ncols = col;
 
     if ( _ncols == 0 ) {
-        fprintf(stderr, "koviz [error]: no params in *.mot file=%s\n",
-                         _motfile.toLatin1().constData());
-        exit(-1);
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: no params in *.mot file="
+            << _motfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
     // Time param should be column 0
     if ( _col2param.value(0)->name() == "time" ) {
         _timeCol = 0;
     } else {
-        fprintf(stderr, "koviz [error]: \"time\" param not found in "
-                        "file=%s\n",  _motfile.toLatin1().constData());
-        exit(-1);
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: \"time\" param not found in file="
+            << _motfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
-    _iteratorTimeIndex = new MotModelIterator(0,this,
-                                              _timeCol,_timeCol,_timeCol);
+    // Map the binary copy written by an earlier parse of the unchanged
+    // log (column-major for wide logs since they're used a column at a time)
+    bool isLazy = TextLogColumnCache::isLazy(_ncols);
+    _sidecar = new TextLogSidecar(_motfile);
+    TextLogSidecar::Layout layout = isLazy ? TextLogSidecar::ColumnMajor
+                                           : TextLogSidecar::RowMajor;
+    const double* sidecarData = _sidecar->map(_ncols,&_nrows,layout);
+    if ( sidecarData ) {
+        _data = (double*)sidecarData;
+        _isColumnMajor = isLazy;
+        if ( mem ) {
+            _file.unmap((uchar*)mem);
+            _mem = 0;
+        }
+        _file.close();
+    } else {
+        delete _sidecar;
+        _sidecar = 0;
 
-    // Get number of data rows in mot file
-    while ( !in.atEnd() ) {
-        in.readLine();
-        ++_nrows;
-    }
+        // Find data rows (in parallel)
+        _parser = new TextLogParser(mem,pos,size,'\t',&MotModel::_convert);
+        _nrows = _parser->rowCount();
 
-    // Allocate to hold *all* parsed data
-    _data = (double*)malloc(_nrows*_ncols*sizeof(double));
+        if ( isLazy ) {
+            // Wide log - keep file mapped and parse columns when first used
+            _columnCache = new TextLogColumnCache(_parser);
 
-    // Skip header
-    in.seek(0);
-    while ( 1 ) {
-        line = in.readLine();
-        if ( line.isNull() ) {
-            break;
-        }
-        if ( line.contains("endheader") ) {
-            break;
-        }
-    }
-    in.readLine();
-
-    // Read in data
-    int i = 0;
-    while ( !in.atEnd() ) {
-        QString line = in.readLine();
-        int from = 0;
-        while (1) {
-            int j = line.indexOf('\t',from);
-            if ( j < 0 ) {
-                _data[i] = _convert(line.mid(from,line.size()-from));
-                ++i;
-                break;
+            // Meanwhile write the binary copy for the next open
+            _sidecarWriter = new TextLogSidecar(_motfile);
+            _sidecarWriter->writeColumns(_parser,_ncols);
+        } else {
+            // Allocate to hold *all* parsed data and parse it (in parallel)
+            _data = (double*)malloc((qint64)_nrows*_ncols*sizeof(double));
+            _nrows = _parser->parseRows(_data,_ncols);
+
+            // Next open of the (unchanged) log maps a binary copy instead
+            if ( _nrows == _parser->rowCount() ) {
+                TextLogSidecar(_motfile).write(_data,_nrows,_ncols);
+            }
+
+            delete _parser;
+            _parser = 0;
+            if ( mem ) {
+                _file.unmap((uchar*)mem);
+                _mem = 0;
             }
-            _data[i] = _convert(line.mid(from,j-from));
-            from = j+1;
-            ++i;
+            _file.close();
         }
     }
 
-    file.close();
+    _iteratorTimeIndex = new MotModelIterator(0,this,
+                                              _timeCol,_timeCol,_timeCol);
+}
+
+const double* MotModel::_pinColumn(int col, int *stride) const
+{
+    if ( _columnCache ) {
+        *stride = 1;
+        return _columnCache->pin(col);
+    }
+    if ( _isColumnMajor ) {
+        *stride = 1;
+        return _data+(qint64)col*_nrows;
+    }
+    *stride = _ncols;
+    return _data+col;
+}
+
+void MotModel::_unpinColumn(int col) const
+{
+    if ( _columnCache ) {
+        _columnCache->unpin(col);
+    }
 }
 
 void MotModel::map()
@@ -157,11 +211,48 @@ ModelIterator *MotModel::begin(int tcol, int xcol, int ycol) const
     return new MotModelIterator(0,this,tcol,xcol,ycol);
 }
 
+void MotModel::fill(int tcol, int xcol, int ycol, int row0, int row1,
+                    double *t, double *x, double *y) const
+{
+    _fillColumn(tcol,row0,row1,t);
+    _fillColumn(xcol,row0,row1,x);
+    _fillColumn(ycol,row0,row1,y);
+}
+
+void MotModel::_fillColumn(int col, int row0, int row1, double *out) const
+{
+    if ( !out ) {
+        return;
+    }
+    int stride;
+    const double* v = _pinColumn(col,&stride);
+    if ( stride == 1 ) {
+        memcpy(out,v+row0,(row1-row0)*sizeof(double));
+    } else {
+        const double* p = v+(qint64)row0*stride;
+        for ( int i = row0; i < row1; ++i ) {
+            *out++ = *p;
+            p += stride;
+        }
+    }
+    _unpinColumn(col);
+}
+
 MotModel::~MotModel()
 {
+    if ( _sidecarWriter ) {
+        // Stops the write (it reads the parser and mapped log)
+        delete _sidecarWriter;
+        _sidecarWriter = 0;
+    }
     foreach ( Parameter* param, _col2param.values() ) {
         delete param;
     }
+    if ( _sidecar ) {
+        delete _sidecar;
+        _sidecar = 0;
+        _data = 0;
+    }
     if ( _data ) {
         free(_data);
         _data = 0;
@@ -171,6 +262,18 @@ MotModel::~MotModel()
         delete _iteratorTimeIndex;
         _iteratorTimeIndex = 0;
     }
+    if ( _columnCache ) {
+        delete _columnCache;
+        _columnCache = 0;
+    }
+    if ( _parser ) {
+        delete _parser;
+        _parser = 0;
+    }
+    if ( _mem ) {
+        _file.unmap((uchar*)_mem);
+        _mem = 0;
+    }
 }
 
 const Parameter* MotModel::param(int col) const
@@ -212,9 +315,10 @@ double MotModel::_convert(const QString &s)
     bool ok;
     val = s.toDouble(&ok);
     if ( !ok ) {
+        // Runs on the parser's pool threads, so warn rather than exit
         fprintf(stderr, "koviz [error]: mot file has bad value=%s\n",
                 s.toLatin1().constData());
-        exit(-1);
+        val = qQNaN();
     }
 
     return val;
@@ -247,7 +351,13 @@ QVariant MotModel::data(const QModelIndex &idx, int role) const
     if ( idx.isValid() && _data ) {
         int row = idx.row();
         int col = idx.column();
-        val = _data[row*_ncols+col];
+        if ( _isColumnMajor ) {
+            val = _data[(qint64)col*_nrows+row];
+        } else {
+            val = _data[(qint64)row*_ncols+col];
+        }
+    } else if ( idx.isValid() && _columnCache ) {
+        val = _columnCache->value(idx.row(),idx.column());
     }
 
     return val;
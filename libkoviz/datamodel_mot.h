@@ -9,12 +9,15 @@
 #include <QTextStream>
 #include <QProgressDialog>
 #include <QFileInfo>
+#include <QFile>
 #include <stdexcept>
 
 #include "datamodel.h"
 #include "parameter.h"
 #include "unit.h"
 #include "timeit_linux.h"
+#include "textlogparser.h"
+#include "textlogsidecar.h"
 
 class MotModel;
 class MotModelIterator;
@@ -37,6 +40,8 @@ class MotModel : public DataModel
     virtual void unmap();
     virtual int paramColumn(const QString& paramName) const ;
     virtual ModelIterator* begin(int tcol, int xcol, int ycol) const ;
+    virtual void fill(int tcol, int xcol, int ycol, int row0, int row1,
+                      double* t, double* x, double* y) const;
     int indexAtTime(double time);
 
     virtual int rowCount(const QModelIndex & pidx = QModelIndex() ) const;
@@ -59,21 +64,31 @@ class MotModel : public DataModel
 
     double* _data;
 
-    static QString _err_string;
-    static QTextStream _err_stream;
+    // Lazy mode (wide logs): file stays mapped, columns parsed on demand
+    QFile _file;
+    const char* _mem;
+    TextLogParser* _parser;
+    TextLogColumnCache* _columnCache;
+    TextLogSidecar* _sidecar;      // if set, _data is mapped from it
+    bool _isColumnMajor;           // _data layout (mapped wide log sidecar)
+    TextLogSidecar* _sidecarWriter; // writes a wide log's sidecar
 
     void _init();
     int _idxAtTimeBinarySearch (MotModelIterator *it,
                                int low, int high, double time);
 
-    inline double _convert(const QString& s);
+    static double _convert(const QString& s);
+
+    const double* _pinColumn(int col, int* stride) const;
+    void _unpinColumn(int col) const;
+    void _fillColumn(int col, int row0, int row1, double* out) const;
 };
 
 class MotModelIterator : public ModelIterator
 {
   public:
 
-    inline MotModelIterator(): i(0) {}
+    inline MotModelIterator(): i(0), _model(0) {}
 
     inline MotModelIterator(int row, // iterator pos
                             const MotModel* model,
@@ -82,9 +97,19 @@ class MotModelIterator : public ModelIterator
         _model(model),
         _tcol(tcol), _xcol(xcol), _ycol(ycol)
     {
+        _t = _model->_pinColumn(_tcol,&_tstride);
+        _x = _model->_pinColumn(_xcol,&_xstride);
+        _y = _model->_pinColumn(_ycol,&_ystride);
     }
 
-    virtual ~MotModelIterator() {}
+    virtual ~MotModelIterator()
+    {
+        if ( _model ) {
+            _model->_unpinColumn(_tcol);
+            _model->_unpinColumn(_xcol);
+            _model->_unpinColumn(_ycol);
+        }
+    }
 
     virtual void start()
     {
@@ -109,17 +134,17 @@ class MotModelIterator : public ModelIterator
 
     inline double t() const
     {
-        return _model->_data[i*_model->_ncols+_tcol];
+        return _t[(qint64)i*_tstride];
     }
 
     inline double x() const
     {
-        return _model->_data[i*_model->_ncols+_xcol];
+        return _x[(qint64)i*_xstride];
     }
 
     inline double y() const
     {
-        return _model->_data[i*_model->_ncols+_ycol];
+        return _y[(qint64)i*_ystride];
     }
 
   private:
@@ -129,6 +154,12 @@ class MotModelIterator : public ModelIterator
     int _tcol;
     int _xcol;
     int _ycol;
+    const double* _t;   // column start, _ncols apart (or 1 apart if lazy)
+    const double* _x;
+    const double* _y;
+    int _tstride;
+    int _xstride;
+    int _ystride;
 };
 
 
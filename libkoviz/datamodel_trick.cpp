@@ -4,28 +4,50 @@
 #include <stdexcept>
 #include <unistd.h>
 
-QString TrickModel::_err_string;
-QTextStream TrickModel::_err_stream(&TrickModel::_err_string);
+bool TrickModel::_isColumnCacheEnabled = true;
+qint64 TrickModel::_columnCacheMaxBytes = 256LL*1024LL*1024LL;
+qint64 TrickModel::_columnCacheBytes = 0;
+quint64 TrickModel::_columnCacheTick = 0;
+QList<const TrickModel*> TrickModel::_columnCacheModels;
+QMutex TrickModel::_columnCacheMutex;
+QWaitCondition TrickModel::_columnCacheReady;
 
 TrickModel::TrickModel(const QStringList& timeNames,
                        const QString& trkfile, QObject *parent) :
     DataModel(timeNames, trkfile, parent),
-    _timeNames(timeNames),_trkfile(trkfile),
+    _timeNames(timeNames),_trkfile(trkfile),_isByteSwapped(false),
     _nrows(0), _row_size(0), _ncols(0), _timeCol(0),_pos_beg_data(0),
-    _mem(0), _data(0), _fd(-1), _file(_trkfile),_iteratorTimeIndex(0)
+    _mem(0), _data(0), _fd(-1), _file(_trkfile),_mapCount(0),
+    _iteratorTimeIndex(0)
 {
     _load_trick_header();
     map();
 }
 
+// Sets up model from a previously read header instead of reading the header
+TrickModel::TrickModel(const QStringList& timeNames,
+                       const QString& trkfile,
+                       const TrickHeader& header, QObject *parent) :
+    DataModel(timeNames, trkfile, parent),
+    _timeNames(timeNames),_trkfile(trkfile),_isByteSwapped(false),
+    _nrows(0), _row_size(0), _ncols(0), _timeCol(0),_pos_beg_data(0),
+    _mem(0), _data(0), _fd(-1), _file(_trkfile),_mapCount(0),
+    _iteratorTimeIndex(0)
+{
+    _load_trick_header(header);
+    map();
+}
+
 bool TrickModel::_load_trick_header()
 {
     bool ret = true;
 
     if (!_file.open(QIODevice::ReadOnly)) {
-        _err_stream << "koviz [error]: could not open "
-                    << _trkfile << "\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: could not open "
+            << _trkfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
     QDataStream in(&_file);
 
@@ -40,13 +62,16 @@ bool TrickModel::_load_trick_header()
     } else if ( data[0] == '0' && data[1] == '7' ) {
         _trick_version = TrickVersion07;
     } else {
-        _err_stream << "koviz [error]: unrecognized file or Trick version: "
-                    << _trkfile << "\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: unrecognized file or Trick version: "
+            << _trkfile << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
     in.readRawData(data,1) ; // -
     in.readRawData(data,1) ; // L or B (endian)
+    _endian = data[0];
     if ( data[0] == 'L' ) {
         in.setByteOrder(QDataStream::LittleEndian);
     } else {
@@ -66,20 +91,72 @@ bool TrickModel::_load_trick_header()
         _col2offset[cc] = _row_size;
         _row_size += _load_binary_param(in,cc);
         TrickParameter* p = _col2param.value(cc);
-        _paramtypes.push_back(p->type());
+        _paramtypes.push_back(_paramType(p));
     }
     if ( _row_size == 0 ) {
-        _err_stream << "koviz [error]: trk file \""
-                    << _file.fileName() << "\" is corrupt!\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: trk file \""
+            << _file.fileName() << "\" is corrupt!\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
+    // Save address of begin location of data for map()
+    _pos_beg_data = _file.pos();
+
+    _init_data_layout(_file.bytesAvailable());
+
+    _file.close();
+
+    return ret;
+}
+
+void TrickModel::_load_trick_header(const TrickHeader &header)
+{
+    _trick_version = (TrickVersion) header.version;
+    _endian = header.endian;
+    _ncols = header.params.size();
+
+    _row_size = 0 ;
+    for ( int cc = 0; cc < _ncols; ++cc) {
+        TrickParameter* p = new TrickParameter(header.params.at(cc));
+        _col2param.insert(cc,p);
+        _param2column.insert(p->name(),cc);
+        _col2offset[cc] = _row_size;
+        _row_size += p->size();
+        _paramtypes.push_back(_paramType(p));
+    }
+    if ( _row_size == 0 ) {
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: trk file \""
+            << _file.fileName() << "\" is corrupt!\n";
+        throw std::runtime_error(msg.toLatin1().constData());
+    }
+
+    _pos_beg_data = header.posBegData;
+
+    _init_data_layout(_file.size()-_pos_beg_data);
+}
+
+// Checks data size against row size, sets row count and time column
+void TrickModel::_init_data_layout(qint64 nbytes)
+{
+    // Payload written on a machine with the other byte order is read
+    // through the column cache, which swaps it once on extraction
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    _isByteSwapped = ( _endian == 'L' );
+#else
+    _isByteSwapped = ( _endian == 'B' );
+#endif
+
     // Sanity check. Bytes remaining should be a multiple of the record size
-    qint64 nbytes = _file.bytesAvailable();
-    if ( nbytes % _row_size != 0 ) {
-        _err_stream << "koviz [error]: trk file \""
-                    << _file.fileName() << "\" is corrupt!\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+    if ( nbytes < 0 || nbytes % _row_size != 0 ) {
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: trk file \""
+            << _file.fileName() << "\" is corrupt!\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
     // Make sure time param exists in model and set time column
@@ -92,24 +169,52 @@ bool TrickModel::_load_trick_header()
         }
     }
     if ( ! isFoundTime ) {
-        _err_stream << "koviz [error]: couldn't find time param \""
-                    << _timeNames.join("=") << "\" in trkfile=" << _trkfile
-                    << ".  Try setting -timeName on commandline option.";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: couldn't find time param \""
+            << _timeNames.join("=") << "\" in trkfile=" << _trkfile
+            << ".  Try setting -timeName on commandline option.";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
-    // Save address of begin location of data for map()
-    _pos_beg_data = _file.pos();
-
     // Calculate number of timestamped records in file
     _nrows = nbytes/(qint64)_row_size;
+}
 
-    _file.close();
-
-    return ret;
+TrickHeader TrickModel::header() const
+{
+    TrickHeader h;
+    h.version = _trick_version;
+    h.endian = _endian;
+    h.posBegData = _pos_beg_data;
+    for ( int cc = 0; cc < _ncols; ++cc) {
+        h.params.append(*(_col2param.value(cc)));
+    }
+    return h;
 }
 
 // Returns byte size of parameter
+// A Trick LONG is as wide as a long was on the machine that logged it,
+// so it's read as the fixed size type of the param's byte size
+int TrickModel::_paramType(const TrickParameter *p) const
+{
+    int type = p->type();
+    if ( _trick_version == TrickVersion10 && type == TRICK_10_LONG ) {
+        if ( p->size() == 8 ) {
+            type = TRICK_10_LONG_LONG;
+        } else if ( p->size() == 4 ) {
+            type = TRICK_10_INTEGER;
+        }
+    } else if ( _trick_version == TrickVersion07 && type == TRICK_07_LONG ) {
+        if ( p->size() == 8 ) {
+            type = TRICK_07_LONG_LONG;
+        } else if ( p->size() == 4 ) {
+            type = TRICK_07_INTEGER;
+        }
+    }
+    return type;
+}
+
 qint32 TrickModel::_load_binary_param(QDataStream& in, int col)
 {
     TrickParameter* param  = new TrickParameter;
@@ -148,22 +253,31 @@ qint32 TrickModel::_load_binary_param(QDataStream& in, int col)
     return sz;
 }
 
+// Maps are counted so that pool threads can map/unmap the same model
+// concurrently, the file is only unmapped when the last user unmaps
 void TrickModel::map()
 {
-    if ( _data ) return; // already mapped
+    QMutexLocker locker(&_mapMutex);
+    if ( _mapCount++ > 0 ) return; // already mapped
 
     if (!_file.open(QIODevice::ReadOnly)) {
-        _err_stream << "koviz [error]: could not open "
-                    << _file.fileName() << "\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+        _mapCount = 0;
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: could not open "
+            << _file.fileName() << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
     _mem = (ptrdiff_t) _file.map(0,_file.size());
 
     if ( _mem == 0 ) {
-        _err_stream << "koviz [error]: TrickModel couldn't allocate memory for : "
-                    << _file.fileName() << "\n";
-        throw std::runtime_error(_err_string.toLatin1().constData());
+        _mapCount = 0;
+        QString msg;
+        QTextStream err(&msg);
+        err << "koviz [error]: TrickModel couldn't allocate memory for : "
+            << _file.fileName() << "\n";
+        throw std::runtime_error(msg.toLatin1().constData());
     }
 
     _data = _mem + _pos_beg_data;
@@ -176,6 +290,14 @@ void TrickModel::map()
 }
 
 void TrickModel::unmap()
+{
+    QMutexLocker locker(&_mapMutex);
+    if ( _mapCount == 0 ) return; // not mapped
+    if ( --_mapCount > 0 ) return; // still in use
+    _unmap();
+}
+
+void TrickModel::_unmap()
 {
     if ( _data ) {
         _file.unmap((uchar*)_mem);
@@ -190,15 +312,209 @@ void TrickModel::unmap()
 
 ModelIterator *TrickModel::begin(int tcol, int xcol, int ycol) const
 {
-    return new TrickModelIterator(0,this,tcol,xcol,ycol);
+    // Iterating a column from the row-major mmap strides over whole rows,
+    // so copy the columns out first (once) and have the iterator read them
+    return new TrickModelIterator(0,this,tcol,xcol,ycol,true);
+}
+
+void TrickModel::fill(int tcol, int xcol, int ycol, int row0, int row1,
+                      double *t, double *x, double *y) const
+{
+    int n = row1-row0;
+    bool isOk = ( !t || extractColumn(tcol,row0,n,t) ) &&
+                ( !x || extractColumn(xcol,row0,n,x) ) &&
+                ( !y || extractColumn(ycol,row0,n,y) );
+    if ( !isOk ) {
+        DataModel::fill(tcol,xcol,ycol,row0,row1,t,x,y);
+    }
 }
 
 TrickModel::~TrickModel()
 {
-    unmap();
+    _mapCount = 0;
+    _unmap();
     foreach ( Parameter* param, _col2param.values() ) {
         delete param;
     }
+    QMutexLocker locker(&_columnCacheMutex);
+    foreach ( TrickColumnCacheEntry entry, _col2cache.values() ) {
+        delete[] entry.column;
+        _columnCacheBytes -= _nrows*sizeof(double);
+    }
+    _col2cache.clear();
+    _columnCacheModels.removeAll(this);
+}
+
+void TrickModel::setColumnCacheEnabled(bool isEnabled)
+{
+    QMutexLocker locker(&_columnCacheMutex);
+    _isColumnCacheEnabled = isEnabled;
+    if ( !isEnabled ) {
+        _evictColumns(_columnCacheBytes);
+    }
+}
+
+void TrickModel::setColumnCacheMaxBytes(qint64 maxBytes)
+{
+    QMutexLocker locker(&_columnCacheMutex);
+    _columnCacheMaxBytes = maxBytes;
+    if ( _columnCacheBytes > _columnCacheMaxBytes ) {
+        _evictColumns(_columnCacheBytes-_columnCacheMaxBytes);
+    }
+}
+
+// Returns cached column and holds a reference to it until
+// _releaseColumn(col).  If not yet cached and isCreate, the column is
+// copied out of the mmap, making room by evicting old columns.
+// Returns 0 if not cached and the cache is off, full (of referenced
+// columns) or the model is unmapped.
+//
+// The copy is made with the cache unlocked so that other columns (and
+// models) can be read meanwhile.  The column's entry is reserved first,
+// and others acquiring it wait until it is ready.
+const double* TrickModel::_acquireColumn(int col, bool isCreate) const
+{
+    QMutexLocker locker(&_columnCacheMutex);
+
+    QHash<int,TrickColumnCacheEntry>::iterator it = _col2cache.find(col);
+    if ( it != _col2cache.end() ) {
+        it.value().refCount++;
+        it.value().lastUsed = ++_columnCacheTick;
+        while ( !it.value().isReady ) {
+            _columnCacheReady.wait(&_columnCacheMutex);
+            it = _col2cache.find(col);  // referenced, so not evicted
+        }
+        return it.value().column;
+    }
+    if ( !isCreate || !_data || !_isColumnCacheEnabled ) {
+        return 0;
+    }
+
+    qint64 nbytes = _nrows*sizeof(double);
+    if ( _columnCacheBytes+nbytes > _columnCacheMaxBytes ) {
+        _evictColumns(_columnCacheBytes+nbytes-_columnCacheMaxBytes);
+        if ( _columnCacheBytes+nbytes > _columnCacheMaxBytes ) {
+            return 0;
+        }
+    }
+
+    // Reserve
+    double* column = new double[_nrows];
+    if ( _col2cache.isEmpty() ) {
+        _columnCacheModels.append(this);
+    }
+    TrickColumnCacheEntry entry;
+    entry.column = column;
+    entry.refCount = 1;
+    entry.lastUsed = ++_columnCacheTick;
+    entry.isReady = false;
+    _col2cache.insert(col,entry);
+    _columnCacheBytes += nbytes;
+
+    // Copy
+    locker.unlock();
+    qint64 co = _col2offset.value(col);
+    int type = _paramtypes.at(col);
+    if ( !TrickColumn::extract((const char*)(_data+co),_row_size,_nrows,
+                               _trick_version == TrickVersion10, type,
+                               column, 1.0, 0.0, _isByteSwapped) ) {
+        // Not a numeric type, _toDouble() reports it
+        for ( qint64 row = 0; row < _nrows; ++row ) {
+            column[row] = _toDouble(_data+row*_row_size+co,type);
+        }
+    }
+
+    // Publish
+    locker.relock();
+    _col2cache[col].isReady = true;
+    _columnCacheReady.wakeAll();
+
+    return column;
+}
+
+void TrickModel::_releaseColumn(int col) const
+{
+    QMutexLocker locker(&_columnCacheMutex);
+    QHash<int,TrickColumnCacheEntry>::iterator it = _col2cache.find(col);
+    if ( it != _col2cache.end() && it.value().refCount > 0 ) {
+        it.value().refCount--;
+    }
+}
+
+// Frees least recently used unreferenced columns (of any model) until
+// nbytes are freed or only referenced columns are left.
+// Call with _columnCacheMutex locked.
+void TrickModel::_evictColumns(qint64 nbytes)
+{
+    qint64 freed = 0;
+    while ( freed < nbytes ) {
+        const TrickModel* lruModel = 0;
+        int lruCol = -1;
+        quint64 lruTick = 0;
+        foreach ( const TrickModel* model, _columnCacheModels ) {
+            QHash<int,TrickColumnCacheEntry>::const_iterator it;
+            for ( it = model->_col2cache.constBegin();
+                  it != model->_col2cache.constEnd(); ++it ) {
+                const TrickColumnCacheEntry& entry = it.value();
+                if ( entry.refCount == 0 &&
+                     (lruModel == 0 || entry.lastUsed < lruTick) ) {
+                    lruModel = model;
+                    lruCol = it.key();
+                    lruTick = entry.lastUsed;
+                }
+            }
+        }
+        if ( lruModel == 0 ) {
+            break;
+        }
+
+        delete[] lruModel->_col2cache.value(lruCol).column;
+        lruModel->_col2cache.remove(lruCol);
+        qint64 colBytes = lruModel->_nrows*sizeof(double);
+        _columnCacheBytes -= colBytes;
+        freed += colBytes;
+        if ( lruModel->_col2cache.isEmpty() ) {
+            _columnCacheModels.removeAll(lruModel);
+        }
+    }
+}
+
+// Fills out with converted, scaled and biased values in one pass, from
+// the column cache if col is cached, otherwise from the mmap.
+// Returns false if rows are out of range or the model is not mapped.
+bool TrickModel::extractColumn(int col, qint64 row0, qint64 n, double *out,
+                               double scale, double bias) const
+{
+    if ( row0 < 0 || n < 0 || row0+n > _nrows ) {
+        return false;
+    }
+
+    const double* column = _acquireColumn(col,false);
+    if ( column ) {
+        bool isOk = TrickColumn::extract((const char*)(column+row0),
+                                         sizeof(double), n,
+                                         true, TRICK_10_DOUBLE,
+                                         out, scale, bias);
+        _releaseColumn(col);
+        return isOk;
+    }
+
+    if ( !_data ) {
+        return false;
+    }
+
+    const char* src = (const char*)(_data + row0*_row_size +
+                                    _col2offset.value(col));
+    int type = _paramtypes.at(col);
+    if ( !TrickColumn::extract(src,_row_size,n,
+                               _trick_version == TrickVersion10, type,
+                               out, scale, bias, _isByteSwapped) ) {
+        for ( qint64 i = 0; i < n; ++i ) {
+            out[i] = _toDouble((ptrdiff_t)(src+i*_row_size),type)*scale+bias;
+        }
+    }
+
+    return true;
 }
 
 const Parameter* TrickModel::param(int col) const
@@ -297,9 +613,6 @@ int TrickModel::columnCount(const QModelIndex &pidx) const
 }
 
 
-// TODO: byteswap like
-//      dp = (double *)(address) ;
-//      value = _swap ? trick_byteswap_double(*dp) : *dp ;
 QVariant TrickModel::data(const QModelIndex &idx, int role) const
 {
     QVariant val;
@@ -309,10 +622,20 @@ QVariant TrickModel::data(const QModelIndex &idx, int role) const
         int col = idx.column();
 
         if ( role == Qt::DisplayRole ) {
-            qint64 _pos_data = row*_row_size + _col2offset.value(col);
-            ptrdiff_t addr = _data+_pos_data;
-            int paramtype =  _paramtypes.at(col);
-            val = _toDouble(addr,paramtype);
+            const double* column = _acquireColumn(col,false);
+            if ( column ) {
+                val = column[row];
+                _releaseColumn(col);
+            } else {
+                qint64 _pos_data = row*_row_size + _col2offset.value(col);
+                ptrdiff_t addr = _data+_pos_data;
+                int paramtype =  _paramtypes.at(col);
+                if ( _isByteSwapped ) {
+                    val = _toDoubleSwapped(addr,paramtype);
+                } else {
+                    val = _toDouble(addr,paramtype);
+                }
+            }
         }
     }
 
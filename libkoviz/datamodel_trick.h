@@ -16,11 +16,16 @@
 #include <QAbstractTableModel>
 #include <QString>
 #include <QStringList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QList>
 #include <vector>
 
 #include "datamodel.h"
 #include "snaptable.h"
 #include "trick_types.h"
+#include "trickcolumn.h"
 #include "parameter.h"
 using namespace std;
 
@@ -56,6 +61,28 @@ private:
     int     _size;
 };
 
+// A column copied out of the mmap into the column cache
+class TrickColumnCacheEntry
+{
+  public:
+    double* column;
+    int refCount;       // iterators and extractions reading column
+    quint64 lastUsed;   // cache tick of last acquire, oldest is evicted first
+    bool isReady;       // false while the column is being copied
+};
+
+// Trk header contents, enough to set up a TrickModel without reading
+// the header from the file (see TrkHeaderCache)
+struct TrickHeader
+{
+    int version;           // TrickModel::TrickVersion
+    char endian;           // 'L' or 'B'
+    qint64 posBegData;
+    QList<TrickParameter> params;
+
+    TrickHeader() : version(0), endian('L'), posBegData(0) {}
+};
+
 class TrickModel : public DataModel
 {
   Q_OBJECT
@@ -73,9 +100,14 @@ class TrickModel : public DataModel
     explicit TrickModel(const QStringList &timeNames,
                         const QString &trkfile,
                        QObject *parent = 0);
+    explicit TrickModel(const QStringList &timeNames,
+                        const QString &trkfile,
+                        const TrickHeader& header,
+                       QObject *parent = 0);
     ~TrickModel();
 
     QString trkFile() const { return _trkfile; }
+    TrickHeader header() const;
 
     virtual const Parameter* param(int col) const ;
 
@@ -86,6 +118,8 @@ class TrickModel : public DataModel
         return _param2column.value(param,-1);
     }
     virtual ModelIterator* begin(int tcol, int xcol, int ycol) const ;
+    virtual void fill(int tcol, int xcol, int ycol, int row0, int row1,
+                      double* t, double* x, double* y) const;
     int indexAtTime(double time);
 
     static void writeTrkHeader(QDataStream &out, const QList<TrickParameter> &params);
@@ -95,6 +129,18 @@ class TrickModel : public DataModel
     virtual QVariant data (const QModelIndex & index,
                            int role = Qt::DisplayRole ) const;
 
+    // Converts rows [row0,row0+n) of col to doubles as v*scale+bias
+    bool extractColumn(int col, qint64 row0, qint64 n, double* out,
+                       double scale=1.0, double bias=0.0) const;
+
+    // Columns iterated over are copied into contiguous double arrays,
+    // shared by all TrickModels up to a total byte budget.  When the
+    // budget is reached the least recently used unreferenced columns
+    // are freed.  Uncached values of byte swapped files are swapped as
+    // they are read.
+    static void setColumnCacheEnabled(bool isEnabled);
+    static void setColumnCacheMaxBytes(qint64 maxBytes);
+
   private:
 
     QStringList _timeNames;
@@ -103,6 +149,8 @@ class TrickModel : public DataModel
     QHash<int,TrickParameter*> _col2param;   // ordered by column
 
     TrickVersion _trick_version;
+    char _endian;
+    bool _isByteSwapped;  // payload endianness differs from this machine's
     vector<int> _paramtypes;
     QHash<QString,int> _param2column;
 
@@ -118,14 +166,29 @@ class TrickModel : public DataModel
     int _fd;
     struct stat _fstat;
     QFile _file;
+    QMutex _mapMutex;
+    int _mapCount;        // map()s not yet unmap()ed
+    void _unmap();
 
     TrickModelIterator* _iteratorTimeIndex;
 
-    static QString _err_string;
-    static QTextStream _err_stream;
+    mutable QHash<int,TrickColumnCacheEntry> _col2cache;
+    const double* _acquireColumn(int col, bool isCreate) const;
+    void _releaseColumn(int col) const;
+    static void _evictColumns(qint64 nbytes);
+    static bool _isColumnCacheEnabled;
+    static qint64 _columnCacheMaxBytes;
+    static qint64 _columnCacheBytes;
+    static quint64 _columnCacheTick;
+    static QList<const TrickModel*> _columnCacheModels; // have cached cols
+    static QMutex _columnCacheMutex;
+    static QWaitCondition _columnCacheReady;
 
     bool _load_trick_header();
+    void _load_trick_header(const TrickHeader& header);
+    void _init_data_layout(qint64 nbytes);
     qint32 _load_binary_param(QDataStream& in, int col);
+    int _paramType(const TrickParameter* p) const;
     int _idxAtTimeBinarySearch (TrickModelIterator *it,
                                int low, int high, double time);
 
@@ -134,6 +197,18 @@ class TrickModel : public DataModel
 
   private:
 
+    // Value at addr in a byte swapped file
+    inline double _toDoubleSwapped(ptrdiff_t addr, int paramtype) const
+    {
+        double val;
+        if ( !TrickColumn::extract((const char*)addr,0,1,
+                                   _trick_version == TrickVersion10,
+                                   paramtype,&val,1.0,0.0,true) ) {
+            val = _toDouble(addr,paramtype); // not numeric, reports it
+        }
+        return val;
+    }
+
     inline double _toDouble(ptrdiff_t addr, int paramtype) const
     {
         if ( _trick_version == TrickVersion07 ) {
@@ -278,26 +353,39 @@ class TrickModelIterator : public ModelIterator
 {
   public:
 
-    inline TrickModelIterator(): i(0) {}
+    inline TrickModelIterator(): i(0), _model(0), _isByteSwapped(false),
+                                 _tcache(0), _xcache(0), _ycache(0) {}
 
+    // If isCache, columns are copied into the model's column cache
+    // (when the cache allows), otherwise already cached columns are used
     inline TrickModelIterator(int row, // iterator pos
                               const TrickModel* model,
-                              int tcol, int xcol, int ycol):
+                              int tcol, int xcol, int ycol,
+                              bool isCache=false):
         i(row),
         _model(model),
         _row_count(model->rowCount()),
         _row_size(model->_row_size),_data(model->_data),
+        _isByteSwapped(model->_isByteSwapped),
         _tcol(tcol), _xcol(xcol), _ycol(ycol),
         _tco(_model->_col2offset.value(tcol)),
         _xco(_model->_col2offset.value(xcol)),
         _yco(_model->_col2offset.value(ycol)),
         _ttype(_model->_paramtypes.at(tcol)),
         _xtype(_model->_paramtypes.at(xcol)),
-        _ytype(_model->_paramtypes.at(ycol))
+        _ytype(_model->_paramtypes.at(ycol)),
+        _tcache(_model->_acquireColumn(tcol,isCache)),
+        _xcache(_model->_acquireColumn(xcol,isCache)),
+        _ycache(_model->_acquireColumn(ycol,isCache))
     {
     }
 
-    virtual ~TrickModelIterator() {}
+    virtual ~TrickModelIterator()
+    {
+        if ( _tcache ) _model->_releaseColumn(_tcol);
+        if ( _xcache ) _model->_releaseColumn(_xcol);
+        if ( _ycache ) _model->_releaseColumn(_ycol);
+    }
 
     virtual void start()
     {
@@ -323,16 +411,34 @@ class TrickModelIterator : public ModelIterator
 
     inline double t() const
     {
+        if ( _tcache ) {
+            return _tcache[i];
+        }
+        if ( _isByteSwapped ) {
+            return _model->_toDoubleSwapped(_data+i*_row_size+_tco,_ttype);
+        }
         return _model->_toDouble(_data+i*_row_size+_tco,_ttype);
     }
 
     inline double x() const
     {
+        if ( _xcache ) {
+            return _xcache[i];
+        }
+        if ( _isByteSwapped ) {
+            return _model->_toDoubleSwapped(_data+i*_row_size+_xco,_xtype);
+        }
         return _model->_toDouble(_data+i*_row_size+_xco,_xtype);
     }
 
     inline double y() const
     {
+        if ( _ycache ) {
+            return _ycache[i];
+        }
+        if ( _isByteSwapped ) {
+            return _model->_toDoubleSwapped(_data+i*_row_size+_yco,_ytype);
+        }
         return _model->_toDouble(_data+i*_row_size+_yco,_ytype);
     }
 
@@ -343,6 +449,7 @@ class TrickModelIterator : public ModelIterator
     int _row_count;
     int _row_size;
     ptrdiff_t _data;
+    bool _isByteSwapped;
     int _tcol;
     int _xcol;
     int _ycol;
@@ -352,6 +459,13 @@ class TrickModelIterator : public ModelIterator
     int _ttype ;
     int _xtype ;
     int _ytype ;
+    const double* _tcache;   // null if column is not in the column cache
+    const double* _xcache;
+    const double* _ycache;
+
+    // Cached columns are reference counted, so no copies
+    TrickModelIterator(const TrickModelIterator&);
+    TrickModelIterator& operator=(const TrickModelIterator&);
 };
 
 
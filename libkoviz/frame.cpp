@@ -61,9 +61,10 @@ void Frame::_calc_topjobs()
             threadIdToTimeIdx.insert(threadId,tidx);
         }
 
-        ModelIterator* it = job->curve()->begin();
-        double rt = it->at(tidx)->x()/1000000.0;
-        delete it;
+        // Read just the frame's row (an iterator would cache the column)
+        double rt;
+        job->curve()->fill(tidx,tidx+1,0,0,&rt);
+        rt = rt/1000000.0;
 
         if ( rt < 0 ) {
             rt = 0.0;
@@ -82,11 +83,7 @@ void Frame::_calc_topjobs()
             if ( len == count ) {
                 qSort(_topjobs.begin(), _topjobs.end(), frameTopJobsGreaterThan);
             }
-            QPair<double,Job*> ljob = _topjobs.last();
-            int ltidx = threadIdToTimeIdx.value(ljob.second->thread_id());
-            ModelIterator* it = ljob.second->curve()->begin();
-            double lrt = it->at(ltidx)->x()/1000000.0;
-            delete it;
+            double lrt = _topjobs.last().first;
             if ( rt > lrt ) {
                 _topjobs.replace(len-1,qMakePair(rt,job));
                 qSort(_topjobs.begin(), _topjobs.end(), frameTopJobsGreaterThan);
@@ -1,6 +1,7 @@
 #include "job.h"
 
 #include <QRegExp>
+#include <QVector>
 #include <stdio.h>
 #include <cmath>
 #include <QtCore/qmath.h>
@@ -41,6 +42,82 @@ QString Job::sim_object_name() const
     return simobj;
 }
 
+JobRuntimeStats::JobRuntimeStats() :
+    _last_nonzero_timestamp(0),
+    _sum_squares(0),
+    _sum_rt(0),
+    _max_rt(0),
+    _max_timestamp(0.0),
+    _cnt(0)
+{
+}
+
+void JobRuntimeStats::add(double time, double rtime)
+{
+    long rt = (long)rtime;
+
+    if ( rt < 0 ) {
+        rt =  0.0;
+    }
+
+    if ( _cnt > 0 && rt > 0 ) {
+        long freq = round_10((long)(time*1000000.0) - _last_nonzero_timestamp);
+        long freq_cnt ;
+        if ( _map_freq.contains(freq) ) {
+            freq_cnt = _map_freq.value(freq)+1;
+        } else {
+            freq_cnt = 0;
+        }
+        _map_freq.insert(freq,freq_cnt);
+        _last_nonzero_timestamp = (long)(time*1000000.0);
+    }
+
+    if ( rt > _max_rt ) {
+        _max_rt = rt;
+        _max_timestamp = time;
+    }
+
+    _sum_squares += rt*rt;
+    _sum_rt += rt;
+
+    ++_cnt;
+}
+
+double JobRuntimeStats::avg_runtime() const
+{
+    double s = (double)_sum_rt;
+    double n = (double)_cnt;
+    return (s/n)/1000000.0;
+}
+
+double JobRuntimeStats::max_runtime() const
+{
+    return (_max_rt)/1000000.0;
+}
+
+double JobRuntimeStats::stddev_runtime() const
+{
+    double ss = (double)_sum_squares;
+    double s = (double)_sum_rt;
+    double n = (double)_cnt;
+    return qSqrt(ss/n - s*s/(n*n))/1000000.0 ;
+}
+
+double JobRuntimeStats::freq() const
+{
+    double f = 0;
+    int max_cnt = 0 ;
+    // Could be multiple frequencies - choose mode
+    foreach ( long freq, _map_freq.keys() ) {
+        int cnt = _map_freq.value(freq);
+        if ( cnt > max_cnt ) {
+            f = freq/1000000.0;
+            max_cnt = cnt;
+        }
+    }
+    return f;
+}
+
 inline void Job::_do_stats()
 {
     if ( _is_stats ) {
@@ -56,72 +133,42 @@ inline void Job::_do_stats()
         exit(-1);
     }
 
-    long freq;
-    QMap<long,int> map_freq;
-    long last_nonzero_timestamp = 0 ;
-
-    long sum_squares = 0 ;
-    long sum_rt = 0 ;
-    long max_rt = 0 ;
-    ModelIterator* it = _curve->begin();
-    int cnt = 0;
-    while ( !it->isDone() ) {
-
-        double time = it->t();
-        long rt = (long)it->y();
-
-        if ( rt < 0 ) {
-            rt =  0.0;
-        }
-
-        if ( cnt > 0 && rt > 0 ) {
-            freq = round_10((long)(time*1000000.0) - last_nonzero_timestamp);
-            long freq_cnt ;
-            if ( map_freq.contains(freq) ) {
-                freq_cnt = map_freq.value(freq)+1;
-            } else {
-                freq_cnt = 0;
-            }
-            map_freq.insert(freq,freq_cnt);
-            last_nonzero_timestamp = (long)(time*1000000.0);
+    // Read in chunks so long runs don't need whole columns in memory
+    const int chunkSize = 65536;
+    JobRuntimeStats stats;
+    int nrows = _curve->rowCount();
+    QVector<double> times(qMin(nrows,chunkSize));
+    QVector<double> rts(qMin(nrows,chunkSize));
+    for ( int row0 = 0; row0 < nrows; row0 += chunkSize ) {
+        int n = qMin(chunkSize,nrows-row0);
+        _curve->fill(row0,row0+n,times.data(),0,rts.data());
+        for ( int i = 0; i < n; ++i ) {
+            stats.add(times.at(i),rts.at(i));
         }
-
-        if ( rt > max_rt ) {
-            max_rt = rt;
-            _max_timestamp = time;
-        }
-
-        sum_squares += rt*rt;
-        sum_rt += rt;
-
-        ++cnt;
-        it->next();
     }
-    delete it;
 
-    double ss = (double)sum_squares;
-    double s = (double)sum_rt;
-    double n = (double)cnt;
+    _setStats(stats);
+}
 
-    _max_runtime = (max_rt)/1000000.0;
-    _avg_runtime = (s/n)/1000000.0;
-    _stddev_runtime = qSqrt(ss/n - s*s/(n*n))/1000000.0 ;
+void Job::setStats(const JobRuntimeStats &stats)
+{
+    _is_stats = true;
+    _setStats(stats);
+}
+
+void Job::_setStats(const JobRuntimeStats &stats)
+{
+    _max_runtime = stats.max_runtime();
+    _avg_runtime = stats.avg_runtime();
+    _stddev_runtime = stats.stddev_runtime();
+    _max_timestamp = stats.max_timestamp();
 
     //
     // (re)Calculate job frequency
     //
     if ( _npoints > 1 ) {
-        int max_cnt = 0 ;
         double savedFreq = _freq;
-        _freq = 0;
-        // Could be multiple frequencies - choose mode
-        foreach ( long freq, map_freq.keys() ) {
-            int cnt = map_freq.value(freq);
-            if ( cnt > max_cnt ) {
-                _freq = freq/1000000.0;
-                max_cnt = cnt;
-            }
-        }
+        _freq = stats.freq();
 
         if ( _job_name == "trick_sys.sched.advance_sim_time" && _freq == 0 ) {
             // With Orlando's RUN I found that I couldn't trust
@@ -256,7 +303,7 @@ double Job::freq()
 
 Job::Job(CurveModel* curve) :
      _curve(curve),_npoints(0),_isFrameTimerJob(false),
-     _is_stats(false)
+     _is_stats(false),_max_timestamp(0.0)
 {
     if ( !curve ) {
         return;
@@ -271,7 +318,7 @@ Job::Job(CurveModel* curve) :
 Job::Job(const QString &jobId) :
      _curve(0),_npoints(0),_isFrameTimerJob(false),
      _log_name(jobId),
-     _is_stats(false)
+     _is_stats(false),_max_timestamp(0.0)
 {
     _parseJobId(_log_name);
 }
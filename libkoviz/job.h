@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QTextStream>
+#include <QMap>
 #include <stdlib.h>
 #include <stdexcept>
 
@@ -10,6 +11,32 @@
 
 class Job;
 
+// Runtime stats of a job accumulated over its logged (time,rt) samples
+// where rt is in microseconds.  Results are in seconds.
+class JobRuntimeStats
+{
+  public:
+    JobRuntimeStats();
+
+    void add(double time, double rt);
+
+    int count() const { return _cnt; }
+    double avg_runtime() const;
+    double max_runtime() const;
+    double max_timestamp() const { return _max_timestamp; }
+    double stddev_runtime() const;
+    double freq() const;    // mode of timestamp deltas, 0 if none
+
+  private:
+    QMap<long,int> _map_freq;
+    long _last_nonzero_timestamp;
+    long _sum_squares;
+    long _sum_rt;
+    long _max_rt;
+    double _max_timestamp;
+    int _cnt;
+};
+
 bool jobAvgTimeGreaterThan(Job* a,Job* b);
 bool jobMaxTimeGreaterThan(Job* a,Job* b);
 
@@ -36,6 +63,10 @@ class Job
     double max_timestamp();
     double stddev_runtime(); // TODO: make unit test
 
+    // Use stats computed elsewhere (e.g. SnapJobStats) instead of
+    // reading the curve on first use
+    void setStats(const JobRuntimeStats& stats);
+
     inline CurveModel* curve() const { return _curve; }
     inline int npoints() const { return _npoints; }
 
@@ -57,6 +88,7 @@ private:
 
     bool _is_stats;
     void _do_stats();
+    void _setStats(const JobRuntimeStats& stats);
     double _avg_runtime;
     double _stddev_runtime;
     double _max_runtime;
@@ -64,9 +64,12 @@ void CurvesLayoutItem::paint(QPainter *painter,
     int nCurves = _bookModel->rowCount(curvesIdx);
 
     // Print!
-    if ( nCurves == 2 ) {
-        QString plotPresentation = _bookModel->getDataString(_plotIdx,
-                                                     "PlotPresentation","Plot");
+    QString plotPresentation = _bookModel->plotPresentation(_plotIdx);
+    if ( plotPresentation == "statistics" ) {
+        if ( nCurves > 0 ) {
+            _printStatsplot(T,painter,_plotIdx);
+        }
+    } else if ( nCurves == 2 ) {
         if ( plotPresentation == "compare" ) {
             _printCoplot(R,T,painter,_plotIdx);
         } else if (plotPresentation == "error" || plotPresentation.isEmpty()) {
@@ -91,21 +94,21 @@ void CurvesLayoutItem::paint(QPainter *painter,
 
         if ( nElements > 100000 || nCurves > 64 ) {
 
-            // Use pixmaps to reduce file size
+            // Use an image to reduce file size (an image rather than a
+            // pixmap since pages may be printed on worker threads)
             double rw = R.width()/(double)painter->device()->logicalDpiX();
             double rh = R.height()/(double)painter->device()->logicalDpiY();
-            QPixmap nullPixmap(1,1); // used for dpi
-            QPainter nullPainter(&nullPixmap);
-            int w = qRound(1.8*rw*nullPainter.device()->logicalDpiX());
-            int h = qRound(1.8*rh*nullPainter.device()->logicalDpiY());
-            QPixmap pixmap(w,h);
+            QImage nullImage(1,1,QImage::Format_RGB32); // used for dpi
+            int w = qRound(1.8*rw*nullImage.logicalDpiX());
+            int h = qRound(1.8*rh*nullImage.logicalDpiY());
+            QImage image(w,h,QImage::Format_RGB32);
 
             QModelIndex pageIdx = _plotIdx.parent().parent();
-            pixmap.fill(_bookModel->pageBackgroundColor(pageIdx));
-            QPainter pixmapPainter(&pixmap);
+            image.fill(_bookModel->pageBackgroundColor(pageIdx));
+            QPainter imagePainter(&image);
             QPen pen;
             pen.setWidth(0);
-            pixmapPainter.setRenderHint(QPainter::Antialiasing);
+            imagePainter.setRenderHint(QPainter::Antialiasing);
 
             QRectF M = _bookModel->getPlotMathRect(_plotIdx);
             double a = w/M.width();
@@ -120,33 +123,32 @@ void CurvesLayoutItem::paint(QPainter *painter,
                 QModelIndex curveIdx = _bookModel->index(i,0,curvesIdx);
                 QPainterPath* path =_bookModel->getPainterPath(curveIdx);
                 if ( path ) {
+                    CurveProps props = _bookModel->curveProps(curveIdx);
+
                     // Line color
-                    QColor color(_bookModel->getDataString(curveIdx,
-                                                         "CurveColor","Curve"));
+                    QColor color(props.color);
                     pen.setColor(color);
-                    pixmapPainter.setPen(pen);
+                    imagePainter.setPen(pen);
 
                     // Scale transform (e.g. for unit axis scaling)
-                    double xs = _bookModel->xScale(curveIdx);
-                    double ys = _bookModel->yScale(curveIdx);
-                    double xb = _bookModel->xBias(curveIdx);
-                    double yb = _bookModel->yBias(curveIdx);
+                    double xs = props.xs;
+                    double ys = props.ys;
+                    double xb = props.xb;
+                    double yb = props.yb;
                     QTransform Tscaled(T);
                     Tscaled = Tscaled.scale(xs,ys);
                     Tscaled = Tscaled.translate(xb/xs,yb/ys);
-                    pixmapPainter.setTransform(Tscaled);
+                    imagePainter.setTransform(Tscaled);
 
                     // Line style
-                    QString lineStyle = _bookModel->getDataString(curveIdx,
-                                                      "CurveLineStyle","Curve");
-                    lineStyle = lineStyle.toLower();
+                    QString lineStyle = props.lineStyle.toLower();
 
                     // Draw curve!
                     if ( lineStyle == "thick_line" ||
                          lineStyle == "x_thick_line" ) {
                         // The transform cannot be used when drawing thick lines
                         QTransform I;
-                        pixmapPainter.setTransform(I);
+                        imagePainter.setTransform(I);
                         double w = pen.widthF();
                         if ( lineStyle == "thick_line" ) {
                             pen.setWidth(5.0);
@@ -157,48 +159,49 @@ void CurvesLayoutItem::paint(QPainter *painter,
                                     "BookView::_paintCurve: bad linestyle\n");
                             exit(-1);
                         }
-                        pixmapPainter.setPen(pen);
+                        imagePainter.setPen(pen);
                         QPointF pLast;
                         for ( int i = 0; i < path->elementCount(); ++i ) {
                             QPainterPath::Element el = path->elementAt(i);
                             QPointF p(el.x,el.y);
                             p = Tscaled.map(p);
                             if  ( i > 0 ) {
-                                pixmapPainter.drawLine(pLast,p);
+                                imagePainter.drawLine(pLast,p);
                             }
                             pLast = p;
                         }
                         pen.setWidthF(w);
-                        pixmapPainter.setPen(pen);
-                        pixmapPainter.setTransform(Tscaled);
+                        imagePainter.setPen(pen);
+                        imagePainter.setTransform(Tscaled);
                     } else if ( lineStyle == "scatter" ) {
                         QTransform I;
-                        pixmapPainter.setTransform(I);
+                        imagePainter.setTransform(I);
                         double w = pen.widthF();
                         pen.setWidth(3.0);
-                        pixmapPainter.setPen(pen);
-                        QBrush origBrush = pixmapPainter.brush();
+                        imagePainter.setPen(pen);
+                        QBrush origBrush = imagePainter.brush();
                         QBrush brush(Qt::SolidPattern);
                         brush.setColor(color);
-                        pixmapPainter.setBrush(brush);
+                        imagePainter.setBrush(brush);
                         double r = pen.widthF();
                         for ( int i = 0; i < path->elementCount(); ++i ) {
                             QPainterPath::Element el = path->elementAt(i);
                             QPointF p(el.x,el.y);
                             p = Tscaled.map(p);
-                            pixmapPainter.drawEllipse(p,r,r);
+                            imagePainter.drawEllipse(p,r,r);
                         }
                         pen.setWidthF(w);
-                        pixmapPainter.setPen(pen);
-                        pixmapPainter.setBrush(origBrush);
-                        pixmapPainter.setTransform(Tscaled);
+                        imagePainter.setPen(pen);
+                        imagePainter.setBrush(origBrush);
+                        imagePainter.setTransform(Tscaled);
                     } else {
-                        pixmapPainter.drawPath(*path);
+                        imagePainter.drawPath(*path);
                     }
                 }
             }
-            QRectF S(pixmap.rect());
-            painter->drawPixmap(R,pixmap,S);
+            imagePainter.end();
+            QRectF S(image.rect());
+            painter->drawImage(R,image,S);
         } else {
             _printCoplot(R,T,painter,_plotIdx);
         }
@@ -234,34 +237,47 @@ void CurvesLayoutItem::_printCoplot(const QRect& R, const QTransform& T,
     for ( int i = 0; i < rc; ++i ) {
 
         QModelIndex curveIdx = _bookModel->index(i,0,curvesIdx);
-        QModelIndex curveDataIdx = _bookModel->getDataIndex(curveIdx,
-                                                           "CurveData","Curve");
-        QVariant v = _bookModel->data(curveDataIdx);
-        CurveModel* curveModel =QVariantToPtr<CurveModel>::convert(v);
+        CurveProps props = _bookModel->curveProps(curveIdx);
+        CurveModel* curveModel = props.curveModel;
 
         if ( curveModel ) {
 
-            double xs = _bookModel->xScale(curveIdx);
-            double ys = _bookModel->yScale(curveIdx);
-            double xb = _bookModel->xBias(curveIdx);
-            double yb = _bookModel->yBias(curveIdx);
+            double xs = props.xs;
+            double ys = props.ys;
+            double xb = props.xb;
+            double yb = props.yb;
 
             QPainterPath* path = new QPainterPath;
             paths << path;
 
+            // Read samples a chunk at a time
+            const int chunkSize = 8192;
             curveModel->map();
-            ModelIterator* it = curveModel->begin();
+            int nrows = curveModel->rowCount();
+            QVector<double> ts(qMin(nrows,chunkSize));
+            QVector<double> xvals(qMin(nrows,chunkSize));
+            QVector<double> yvals(qMin(nrows,chunkSize));
+            double yFirst = 0.0;
 
             bool isFirst = true;
-            while ( !it->isDone() ) {
+            int row0 = 0;
+            for ( int i = 0; i < nrows; ++i ) {
+
+                if ( i % chunkSize == 0 ) {
+                    row0 = i;
+                    curveModel->fill(row0,qMin(row0+chunkSize,nrows),
+                                     ts.data(),xvals.data(),yvals.data());
+                    if ( i == 0 ) {
+                        yFirst = yvals.at(0);
+                    }
+                }
 
-                if ( it->t() < start || it->t() > stop ) {
-                    it->next();
+                if ( ts.at(i-row0) < start || ts.at(i-row0) > stop ) {
                     continue;
                 }
 
-                double x = it->x()*xs+xb;
-                double y = it->y()*ys+yb;
+                double x = xvals.at(i-row0)*xs+xb;
+                double y = yvals.at(i-row0)*ys+yb;
                 if ( isXLogScale ) x = log10(x);
                 if ( isYLogScale ) y = log10(y);
                 QPointF p(x,y);
@@ -273,17 +289,13 @@ void CurvesLayoutItem::_printCoplot(const QRect& R, const QTransform& T,
                 } else {
                     path->lineTo(p);
                 }
-
-                it->next();
             }
-            delete it;
+            curveModel->unmap();
 
             // If curve is flat (constant), label with "Flatline=#"
             QRectF curveBBox = path->boundingRect();
-            if ( curveBBox.height() == 0.0 ) {
-                it = curveModel->begin();
-                double y = it->y()*ys+yb;  // y is constant, so use first point
-                delete it;
+            if ( curveBBox.height() == 0.0 && nrows > 0 ) {
+                double y = yFirst*ys+yb; // y is constant, use first point
                 QString s;
                 s = s.sprintf("%.9g",y);
                 QVariant v(s);
@@ -295,15 +307,12 @@ void CurvesLayoutItem::_printCoplot(const QRect& R, const QTransform& T,
                 }
                 s = QString("Flatline=%1").arg(s);
                 int h = painter->fontMetrics().height();
-                QColor color( _bookModel->getDataString(curveIdx,
-                                                        "CurveColor","Curve"));
+                QColor color(props.color);
                 QPen pen = painter->pen();
                 pen.setColor(color);
                 painter->setPen(pen);
                 painter->drawText(curveBBox.topLeft()-QPointF(0,h+10),s);
             }
-
-            curveModel->unmap();
         }
     }
 
@@ -327,17 +336,13 @@ void CurvesLayoutItem::_printCoplot(const QRect& R, const QTransform& T,
     int i = 0;
     foreach ( QPainterPath* path, paths ) {
         QModelIndex curveIdx = _bookModel->index(i,0,curvesIdx);
-        QColor color( _bookModel->getDataString(curveIdx,
-                                                "CurveColor","Curve"));
+        CurveProps props = _bookModel->curveProps(curveIdx);
+        QColor color(props.color);
         pen.setColor(color);
-        QString linestyle =  _bookModel->getDataString(curveIdx,
-                                                      "CurveLineStyle","Curve");
-        pen.setDashPattern(_bookModel->getLineStylePattern(linestyle));
+        pen.setDashPattern(_bookModel->getLineStylePattern(props.lineStyle));
 
         // Handle thick_line and x_thick_line styles
-        QString style = _bookModel->getDataString(curveIdx,
-                                                  "CurveLineStyle","Curve");
-        style = style.toLower();
+        QString style = props.lineStyle.toLower();
         double penWidthOrig = pen.widthF();
         if ( style == "thick_line" ) {
             if ( pen.widthF() == 0.0 ) {
@@ -378,9 +383,7 @@ void CurvesLayoutItem::_printCoplot(const QRect& R, const QTransform& T,
         pen.setWidthF(penWidthOrig);
 
         // Draw symbols
-        QString symbolStyle = _bookModel->getDataString(curveIdx,
-                                                   "CurveSymbolStyle", "Curve");
-        symbolStyle = symbolStyle.toLower();
+        QString symbolStyle = props.symbolStyle.toLower();
         if ( !symbolStyle.isEmpty() && symbolStyle != "none" ) {
             QVector<qreal> pattern;
             pen.setDashPattern(pattern); // plain lines for drawing symbols
@@ -585,37 +588,57 @@ void CurvesLayoutItem::_printErrorplot(const QRect& R,
     double tolerance = _bookModel->getDataDouble(QModelIndex(),
                                                    "TimeMatchTolerance");
     QList<QPointF> pts;
-    double k0 = _bookModel->getDataDouble(curveIdx0,"CurveYScale","Curve");
-    double k1 = _bookModel->getDataDouble(curveIdx1,"CurveYScale","Curve");
+    double k0 = _bookModel->curveProps(curveIdx0).yScale;
+    double k1 = _bookModel->curveProps(curveIdx1).yScale;
     double ys0 = _bookModel->yScale(curveIdx0);
     double ys1 = (k1/k0)*_bookModel->yScale(curveIdx1);
+    // Each curve is read a chunk at a time as the match walks it
+    const int chunkSize = 8192;
     c0->map();
     c1->map();
-    ModelIterator* i0 = c0->begin();
-    ModelIterator* i1 = c1->begin();
-    while ( !i0->isDone() && !i1->isDone() ) {
-        double t0 = i0->t();
-        double t1 = i1->t();
+    int n0 = c0->rowCount();
+    int n1 = c1->rowCount();
+    QVector<double> t0s(qMin(n0,chunkSize));
+    QVector<double> y0s(qMin(n0,chunkSize));
+    QVector<double> t1s(qMin(n1,chunkSize));
+    QVector<double> y1s(qMin(n1,chunkSize));
+    int beg0 = 0;
+    int end0 = 0;
+    int beg1 = 0;
+    int end1 = 0;
+    int i0 = 0;
+    int i1 = 0;
+    while ( i0 < n0 && i1 < n1 ) {
+        if ( i0 >= end0 ) {
+            beg0 = i0;
+            end0 = qMin(i0+chunkSize,n0);
+            c0->fill(beg0,end0,t0s.data(),0,y0s.data());
+        }
+        if ( i1 >= end1 ) {
+            beg1 = i1;
+            end1 = qMin(i1+chunkSize,n1);
+            c1->fill(beg1,end1,t1s.data(),0,y1s.data());
+        }
+        double t0 = t0s.at(i0-beg0);
+        double t1 = t1s.at(i1-beg1);
         if ( qAbs(t1-t0) < tolerance ) {
             if ( t0 >= start && t0 <= stop ) {
-                double d = ys0*i0->y() - ys1*i1->y();
+                double d = ys0*y0s.at(i0-beg0) - ys1*y1s.at(i1-beg1);
                 pts << QPointF(t0,d);
             }
-            i0->next();
-            i1->next();
+            ++i0;
+            ++i1;
         } else {
             if ( t0 < t1 ) {
-                i0->next();
+                ++i0;
             } else if ( t1 < t0 ) {
-                i1->next();
+                ++i1;
             } else {
                 fprintf(stderr,"koviz [bad scoobs]:2: _printErrorplot()\n");
                 exit(-1);
             }
         }
     }
-    delete i0;
-    delete i1;
     c0->unmap();
     c1->unmap();
 
@@ -669,6 +692,43 @@ void CurvesLayoutItem::_printErrorplot(const QRect& R,
     painter->restore();
 }
 
+void CurvesLayoutItem::_printStatsplot(const QTransform& T,
+                                       QPainter *painter,
+                                       const QModelIndex &plotIdx)
+{
+    QModelIndex curvesIdx = _bookModel->getIndex(plotIdx,"Curves","Plot");
+
+    QList<QPainterPath> paths;
+    for ( int b = 0; b < CurveStats::NumBands; ++b ) {
+        QPainterPath* path = _bookModel->getCurvesStatsPath(curvesIdx,
+                                                      (CurveStats::Band) b);
+        paths << T.map(*path);
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QPen origPen = painter->pen();
+    QPen pen(painter->pen());
+    double xHeight = painter->fontMetrics().xHeight();
+    for ( int b = 0; b < CurveStats::NumBands; ++b ) {
+        CurveStats::Band band = (CurveStats::Band) b;
+        QString style = _bookModel->statsBandLineStyle(band);
+        double w = xHeight/11.0;
+        if ( style == "thick_line" ) {
+            w *= 3.0;
+        }
+        pen.setWidthF(w);
+        pen.setColor(_bookModel->statsBandColor(band));
+        pen.setDashPattern(_bookModel->getLineStylePattern(style));
+        painter->setPen(pen);
+        painter->drawPath(paths.at(b));  // print!
+    }
+
+    painter->setPen(origPen);
+    painter->restore();
+}
+
 void CurvesLayoutItem::_paintGrid(QPainter* painter,
                                   const QRect &R,const QRect &RG,
                                   const QRect &C, const QRectF &M)
@@ -769,9 +829,8 @@ void CurvesLayoutItem::_paintCurvesLegend(const QRect& R,
         return;
     }
 
-    QString pres = _bookModel->getDataString(curvesIdx.parent(),
-                                             "PlotPresentation","Plot");
-    if ( pres == "error" ) {
+    QString pres = _bookModel->plotPresentation(curvesIdx.parent());
+    if ( pres == "error" || pres == "statistics" ) {
         return;
     }
 
@@ -2,6 +2,7 @@
 #define LAYOUTITEM_CURVES_H
 
 #include <QPixmap>
+#include <QImage>
 #include "layoutitem_paintable.h"
 #include "bookmodel.h"
 
@@ -34,6 +35,8 @@ private:
                       QPainter *painter, const QModelIndex &plotIdx);
     void _printErrorplot(const QRect& R, const QTransform& T,
                       QPainter *painter, const QModelIndex &plotIdx);
+    void _printStatsplot(const QTransform& T,
+                      QPainter *painter, const QModelIndex &plotIdx);
     void __paintSymbol(const QPointF &p,
                        const QString &symbol, QPainter* painter);
     void _paintGrid(QPainter* painter,
@@ -395,9 +395,8 @@ void PageTitleLayoutItem::_paintPageLegend(const QRect &R,
                                            QPainter* painter)
 {
     QModelIndex plotIdx = curvesIdx.parent();
-    QString pres = _bookModel->getDataString(plotIdx,
-                                             "PlotPresentation","Plot");
-    if ( pres == "error" ) {
+    QString pres = _bookModel->plotPresentation(plotIdx);
+    if ( pres == "error" || pres == "statistics" ) {
         return;
     }
 
@@ -93,7 +93,21 @@ SOURCES += bookmodel.cpp \
            layoutitem_paintable.cpp \
            mapvalue.cpp \
            curvemodelparameter.cpp \
-           datamodel_mot.cpp
+           datamodel_mot.cpp \
+           curvelod.cpp \
+           trkheadercache.cpp \
+           trickcolumn.cpp \
+           textlogparser.cpp \
+           textlogsidecar.cpp \
+           curvesrenderer.cpp \
+           curvehitindex.cpp \
+           curvetimeindex.cpp \
+           pagepicture.cpp \
+           curvestats.cpp \
+           curvepathbuild.cpp \
+           curvesloader.cpp \
+           curveprops.cpp \
+           snapjobstats.cpp
 
 HEADERS  += bookmodel.h \
             bookidxview.h \
@@ -162,7 +176,21 @@ HEADERS  += bookmodel.h \
             layoutitem_paintable.h \
             mapvalue.h \
             curvemodelparameter.h \
-            datamodel_mot.h
+            datamodel_mot.h \
+            curvelod.h \
+            trkheadercache.h \
+            trickcolumn.h \
+            textlogparser.h \
+            textlogsidecar.h \
+            curvesrenderer.h \
+            curvehitindex.h \
+            curvetimeindex.h \
+            pagepicture.h \
+            curvestats.h \
+            curvepathbuild.h \
+            curvesloader.h \
+            curveprops.h \
+            snapjobstats.h
 
 FLEXSOURCES = product_lexer.l
 BISONSOURCES = product_parser.y
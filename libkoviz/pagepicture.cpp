@@ -0,0 +1,30 @@
+#include "pagepicture.h"
+
+PagePicture::PagePicture(const QPaintDevice *target) :
+    QPicture()
+{
+    _metrics.insert(PdmWidth,target->width());
+    _metrics.insert(PdmHeight,target->height());
+    _metrics.insert(PdmWidthMM,target->widthMM());
+    _metrics.insert(PdmHeightMM,target->heightMM());
+    _metrics.insert(PdmNumColors,target->colorCount());
+    _metrics.insert(PdmDepth,target->depth());
+    _metrics.insert(PdmDpiX,target->logicalDpiX());
+    _metrics.insert(PdmDpiY,target->logicalDpiY());
+    _metrics.insert(PdmPhysicalDpiX,target->physicalDpiX());
+    _metrics.insert(PdmPhysicalDpiY,target->physicalDpiY());
+    _metrics.insert(PdmDevicePixelRatio,target->devicePixelRatio());
+#if QT_VERSION >= 0x050600
+    _metrics.insert(PdmDevicePixelRatioScaled,
+                    qRound(target->devicePixelRatioF()*
+                           QPaintDevice::devicePixelRatioFScale()));
+#endif
+}
+
+int PagePicture::metric(PaintDeviceMetric m) const
+{
+    if ( _metrics.contains(m) ) {
+        return _metrics.value(m);
+    }
+    return QPicture::metric(m);
+}
@@ -0,0 +1,26 @@
+#ifndef PAGEPICTURE_H
+#define PAGEPICTURE_H
+
+#include <QPicture>
+#include <QPaintDevice>
+#include <QHash>
+
+// A QPicture that reports the metrics (size, dpi) of the device it will
+// be played back on, e.g. a pdf printer
+//
+// A page laid out for the target device paints into it exactly as it
+// would on the target, so pages can be painted on worker threads and
+// then played back on the target in order.
+class PagePicture : public QPicture
+{
+  public:
+    PagePicture(const QPaintDevice* target);
+
+  protected:
+    int metric(PaintDeviceMetric m) const;
+
+  private:
+    QHash<int,int> _metrics;
+};
+
+#endif // PAGEPICTURE_H
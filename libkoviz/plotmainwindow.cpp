@@ -900,6 +900,16 @@ void PlotMainWindow::savePdf(const QString& fname)
     }
 }
 
+void PlotMainWindow::waitForCurves()
+{
+    _varsWidget->waitForCurves();
+}
+
+void PlotMainWindow::setPrintThreadCount(int nThreads)
+{
+    _bookView->setPrintThreadCount(nThreads);
+}
+
 void PlotMainWindow::_savePdf()
 {
     QString fname = QFileDialog::getSaveFileName(this,
@@ -1521,11 +1531,13 @@ void PlotMainWindow::_liveTimeNext()
 
     if ( curveModel ) {
 
-        curveModel->map();
-
-        ModelIterator* it = curveModel->begin();
+        CurveTimeIndex* timeIndex = _bookModel->getCurveTimeIndex(curveIdx);
+        int rc = timeIndex->count();
+        if ( rc == 0 ) {
+            return;
+        }
 
-        // Calculate curve time index
+        // Calculate curve time index (first of possible duplicates)
         int i = 0;
         double xs = _bookModel->xScale(curveIdx);
         double xb = _bookModel->xBias(curveIdx);
@@ -1534,23 +1546,12 @@ void PlotMainWindow::_liveTimeNext()
         double liveTime = _bookModel->data(liveIdx).toDouble();
         bool isXTime = (curveModel->x()->name() == curveModel->t()->name());
         if ( isXTime ) {
-            i = curveModel->indexAtTime((liveTime-xb)/xs);
+            i = timeIndex->indexAtTime((liveTime-xb)/xs);
         } else {
             // e.g. ball xy curve where x is position[0]
-            i = curveModel->indexAtTime(liveTime);
+            i = timeIndex->indexAtTime(liveTime);
         }
 
-        /* Timestamps may duplicate, go to first in series */
-        double itTime = it->at(i)->t();
-        while ( i > 0 ) {
-            if ( it->at(i-1)->t() == itTime ) {
-                --i;
-            } else {
-                break;
-            }
-        }
-
-
         QModelIndex lctIdx = _bookModel->getDataIndex(QModelIndex(),
                                                       "LiveCoordTimeIndex","");
         int ii = _bookModel->getDataInt(QModelIndex(),
@@ -1558,12 +1559,11 @@ void PlotMainWindow::_liveTimeNext()
 
         // Calculate nextTime after liveTime
         double nextTime = liveTime;
-        it = it->at(i+1+ii);
-        while ( !it->isDone() ) {
+        for ( int k = i+1+ii; k < rc; ++k ) {
             if ( isXTime ) {
-                nextTime = it->x()*xs+xb;
+                nextTime = timeIndex->time(k)*xs+xb;
             } else {
-                nextTime = it->t();
+                nextTime = timeIndex->time(k);
             }
             double dt = qAbs(nextTime-liveTime);
             if ( dt == 0.0 ) {
@@ -1579,9 +1579,7 @@ void PlotMainWindow::_liveTimeNext()
             if ( dt > 1.0e-16 ) {
                 break;
             }
-            it->next();
         }
-        delete it;
 
         // nextTime should not exceed stop time
         double stop  = _bookModel->getDataDouble(QModelIndex(),"StopTime");
@@ -1589,8 +1587,6 @@ void PlotMainWindow::_liveTimeNext()
 
         // Update liveTime to nextTime
         _bookModel->setData(liveIdx,nextTime);
-
-        curveModel->unmap();
     }
 }
 
@@ -1601,9 +1597,12 @@ void PlotMainWindow::_liveTimePrev()
 
     if ( curveModel ) {
 
-        curveModel->map();
+        CurveTimeIndex* timeIndex = _bookModel->getCurveTimeIndex(curveIdx);
+        if ( timeIndex->count() == 0 ) {
+            return;
+        }
 
-        // Calculate curve time index
+        // Calculate curve time index (first of possible duplicates)
         int i = 0;
         double xs = _bookModel->xScale(curveIdx);
         double xb = _bookModel->xBias(curveIdx);
@@ -1612,38 +1611,25 @@ void PlotMainWindow::_liveTimePrev()
         double liveTime = _bookModel->data(liveIdx).toDouble();
         bool isXTime = (curveModel->x()->name() == curveModel->t()->name());
         if ( isXTime ) {
-            i = curveModel->indexAtTime((liveTime-xb)/xs);
+            i = timeIndex->indexAtTime((liveTime-xb)/xs);
         } else {
             // e.g. ball xy curve where x is position[0]
-            i = curveModel->indexAtTime(liveTime);
+            i = timeIndex->indexAtTime(liveTime);
         }
 
         double prevTime = liveTime;
-        ModelIterator* it = curveModel->begin();
-
-        /* Timestamps may be identical, set i to first duplicate */
-        double itTime = it->at(i)->t();
-        while ( i >= 1 ) {
-            if ( it->at(i-1)->t() == itTime ) {
-                --i;
-            } else {
-                break;
-            }
-        }
 
         /* Get current index for possible duplicate timestamps (ii) */
         QModelIndex idx = _bookModel->getDataIndex(QModelIndex(),
                                                    "LiveCoordTimeIndex","");
         int ii = _bookModel->getDataInt(QModelIndex(),
                                         "LiveCoordTimeIndex","");
-
-
         while ( i+ii > 0 ) {
-            it = it->at(i+ii-1);
+            int k = i+ii-1;
             if ( isXTime ) {
-                prevTime = it->x()*xs+xb;
+                prevTime = timeIndex->time(k)*xs+xb;
             } else {
-                prevTime = it->t();
+                prevTime = timeIndex->time(k);
             }
             double dt = qAbs(liveTime-prevTime);
             if ( dt == 0 ) {
@@ -1652,25 +1638,14 @@ void PlotMainWindow::_liveTimePrev()
                 _bookModel->setData(idx,--ii);
                 break;
             } else {
-                int jj = 0;  // Last index of possible duplicate timestamps
-                int j = i-1;
-                double jTime = it->at(j+ii)->t();
-                while ( j+ii-1 >= 0 ) {
-                    if ( it->at(j+ii-1)->t() == jTime ) {
-                        ++jj;
-                        --j;
-                    } else {
-                        break;
-                    }
-                }
-                _bookModel->setData(idx,jj);
+                // Land on last of possible duplicate timestamps
+                _bookModel->setData(idx,k-timeIndex->runBegin(k));
             }
             if ( dt > 1.0e-16 ) {
                 break;
             }
             --i;
         }
-        delete it;
 
         // prevTime should not precede start time
         double start  = _bookModel->getDataDouble(QModelIndex(),"StartTime");
@@ -1678,8 +1653,6 @@ void PlotMainWindow::_liveTimePrev()
 
         // Update liveTime to prevTime
         _bookModel->setData(liveIdx,prevTime);
-
-        curveModel->unmap();
     }
 }
 void PlotMainWindow::_monteInputsHeaderViewClicked(int section)
@@ -68,6 +68,8 @@ public:
                              QWidget *parent = 0);
 
      void savePdf(const QString& fname);
+     void waitForCurves();
+     void setPrintThreadCount(int nThreads);
 
     ~PlotMainWindow();
 
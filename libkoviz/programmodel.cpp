@@ -88,34 +88,44 @@ void ProgramModel::_init(const QList<CurveModel*>& inputCurves,
     _iteratorTimeIndex = new ProgramModelIterator(0,this,
                                                   _timeCol,_timeCol,_timeCol);
 
-    // Get number of data rows in program file
+    // Get number of data rows in program file (inputs are read in chunks
+    // so long runs don't need whole columns in memory)
+    const int chunkSize = 8192;
     foreach ( CurveModel* curveModel, inputCurves ) {
         curveModel->map();
-        ModelIterator* it = curveModel->begin();
+        int n = curveModel->rowCount();
+        QVector<double> ts(qMin(n,chunkSize));
+        int tsBeg = 0;
+        int tsEnd = 0;
 
         int i = 0;
-        while ( !it->isDone() ) {
+        int j = 0;
+        while ( j < n ) {
 
-            double t = it->t();
+            if ( j >= tsEnd ) {
+                tsBeg = j;
+                tsEnd = qMin(j+chunkSize,n);
+                curveModel->fill(tsBeg,tsEnd,ts.data(),0,0);
+            }
+            double t = ts.at(j-tsBeg);
 
             if ( i >= _timeStamps.size() ) {
                 _timeStamps.append(t);
-                it->next();
+                ++j;
                 ++i;
                 continue;
             }
 
             double timeStamp = _timeStamps.at(i);
             if ( t == timeStamp ) {
-                it->next();
+                ++j;
             } else if ( t < timeStamp ) {
                 _timeStamps.insert(i,t);
-                it->next();
+                ++j;
             }
             ++i;
         }
 
-        delete it;
         curveModel->unmap();
     }
     _nrows = _timeStamps.size();
@@ -154,16 +164,24 @@ void ProgramModel::_init(const QList<CurveModel*>& inputCurves,
             bias = Unit::bias(curveModel->y()->unit(), inputParam.unit());
         }
         curveModel->map();
-        ModelIterator* it = curveModel->begin();
-        row = 0;
-        while ( !it->isDone() ) {
+        int n = curveModel->rowCount();
+        QVector<double> ts(qMin(n,chunkSize));
+        QVector<double> ys(qMin(n,chunkSize));
+        int row0 = 0;
+        for ( row = 0; row < n; ++row ) {
+
+            if ( row % chunkSize == 0 ) {
+                row0 = row;
+                curveModel->fill(row0,qMin(row0+chunkSize,n),
+                                 ts.data(),0,ys.data());
+            }
 
             double timeStamp = _data[row*_ncols];
 
-            double t = it->t();
+            double t = ts.at(row-row0);
 
             if ( t == timeStamp ) {
-                input_data[row*nInputs+col] = it->y()*sf+bias;
+                input_data[row*nInputs+col] = ys.at(row-row0)*sf+bias;
             } else if ( timeStamp < t ) {
                 // Interpolate
             } else {
@@ -173,12 +191,8 @@ void ProgramModel::_init(const QList<CurveModel*>& inputCurves,
                                 t,timeStamp,row);
                 exit(-1);
             }
-
-            it->next();
-            ++row;
         }
 
-        delete it;
         curveModel->unmap();
         ++col;
     }
@@ -217,6 +231,17 @@ ModelIterator *ProgramModel::begin(int tcol, int xcol, int ycol) const
     return new ProgramModelIterator(0,this,tcol,xcol,ycol);
 }
 
+void ProgramModel::fill(int tcol, int xcol, int ycol, int row0, int row1,
+                        double *t, double *x, double *y) const
+{
+    for ( int i = row0; i < row1; ++i ) {
+        const double* row = _data+i*_ncols;
+        if ( t ) *t++ = row[tcol];
+        if ( x ) *x++ = row[xcol];
+        if ( y ) *y++ = row[ycol];
+    }
+}
+
 ProgramModel::~ProgramModel()
 {
     foreach ( Parameter* param, _col2param.values() ) {
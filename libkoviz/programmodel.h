@@ -45,6 +45,8 @@ class ProgramModel : public DataModel
     virtual void unmap();
     virtual int paramColumn(const QString& paramName) const ;
     virtual ModelIterator* begin(int tcol, int xcol, int ycol) const ;
+    virtual void fill(int tcol, int xcol, int ycol, int row0, int row1,
+                      double* t, double* x, double* y) const;
     int indexAtTime(double time);
 
     virtual int rowCount(const QModelIndex & pidx = QModelIndex() ) const;
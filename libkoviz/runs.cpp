@@ -1,8 +1,34 @@
 #include "runs.h"
+#include "datamodel_trick.h"
+#include "trkheadercache.h"
 
 QString Runs::_err_string;
 QTextStream Runs::_err_stream(&Runs::_err_string);
 
+// Loads a single log file on a pool thread
+class RunsFileLoader : public QRunnable
+{
+  public:
+    RunsFileLoader(const Runs* runs, const QString& fname,
+                   const TrkHeaderCache* cache,
+                   Runs::LoadedFile* loaded, QAtomicInt* nLoaded) :
+        _runs(runs), _fname(fname), _cache(cache),
+        _loaded(loaded), _nLoaded(nLoaded) {}
+
+    void run()
+    {
+        _runs->_loadFile(_fname,_cache,_loaded);
+        _nLoaded->fetchAndAddOrdered(1);
+    }
+
+  private:
+    const Runs* _runs;
+    QString _fname;
+    const TrkHeaderCache* _cache;
+    Runs::LoadedFile* _loaded;
+    QAtomicInt* _nLoaded;
+};
+
 Runs::Runs() :
     _runDirs(QStringList()),
     _varMap(QHash<QString,QStringList>()),
@@ -109,72 +135,92 @@ void Runs::_init()
         progress->setMinimumDuration(500);
     }
 
+    // Load models in parallel.  The csv model puts up its own progress
+    // dialog, so csv files are loaded here in the gui thread while the
+    // pool works through the others.
+    QHash<QString,TrkHeaderCache*> runToCache;
+    foreach ( QString run, _runDirs ) {
+        if ( !runToCache.contains(run) ) {
+            runToCache.insert(run,new TrkHeaderCache(run));
+        }
+    }
+    QVector<LoadedFile> loaded(nFiles);
+    QAtomicInt nLoaded(0);
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    QList<int> guiFiles;
+    for ( int i = 0; i < nFiles; ++i ) {
+        if ( QFileInfo(files.at(i)).suffix() == "csv" ) {
+            guiFiles.append(i);
+        } else {
+            TrkHeaderCache* cache = runToCache.value(fileToRun.value(
+                                                                files.at(i)));
+            pool.start(new RunsFileLoader(this,files.at(i),cache,
+                                          &loaded[i],&nLoaded));
+        }
+    }
+    foreach ( int i, guiFiles ) {
+        _loadFile(files.at(i),0,&loaded[i]);
+        nLoaded.fetchAndAddOrdered(1);
+    }
+    while ( !pool.waitForDone(100) ) {
+        if ( _isShowProgress && nFiles > 7 ) {
+            // Only show progress when loading many files (7 is arbitrary)
+            progress->setValue(nLoaded.fetchAndAddOrdered(0));
+            if (progress->wasCanceled()) {
+                // Let loaders already running finish before tearing down
+                pool.clear();
+                pool.waitForDone();
+                for ( int i = 0; i < nFiles; ++i ) {
+                    delete loaded.at(i).model;
+                }
+                foreach ( TrkHeaderCache* cache, runToCache.values() ) {
+                    delete cache;
+                }
+                delete progress;
+                exit(0);
+            }
+        }
+    }
+
+    // Merge results in file order so params and models are deterministic
     QHash<QString,QStringList> runToParams;
     QHash<QPair<QString,QString>,DataModel*> pfnameToModel;
-    int i = 0;
-    foreach (QString fname, files ) {
-        if ( _isShowProgress ) {
-            if ( nFiles > 7 ) {
-                // Only show progress when loading many files (7 is arbitrary)
-                progress->setValue(i);
-                if (progress->wasCanceled()) {
-                    exit(0);
-                }
-            } else {
-                progress->setValue(files.size());
+    for ( int i = 0; i < nFiles; ++i ) {
+        if ( !loaded.at(i).err.isEmpty() ) {
+            for ( int j = 0; j < nFiles; ++j ) {
+                delete loaded.at(j).model;
+            }
+            foreach ( TrkHeaderCache* cache, runToCache.values() ) {
+                delete cache;
             }
+            delete progress;
+            throw std::runtime_error(loaded.at(i).err.toLatin1().constData());
         }
-        DataModel* m = DataModel::createDataModel(_timeNames,fname);
-        m->unmap();
+    }
+    for ( int i = 0; i < nFiles; ++i ) {
+        QString fname = files.at(i);
+        DataModel* m = loaded.at(i).model;
         _models.append(m);
-        int ncols = m->columnCount();
-        QStringList mParams;
-        for ( int col = 0; col < ncols; ++col ) {
-            QString p = m->param(col)->name();
-            foreach (QString key, _varMap.keys() ) {
-                if ( p == key ) {
-                    break;
-                }
-                QString runDir = QFileInfo(fname).absolutePath();
-                QStringList vals = _varMap.value(key);
-                QStringList names;
-                foreach ( QString val, vals ) {
-                    MapValue mapval(val);
-                    names.append(mapval.name());
-                }
-                if ( names.contains(p) ) {
-                    p = key;
-                    break;
-                } else {
-                    bool isFound = false;
-                    foreach (QString val, vals) {
-                        if ( val.contains(':') ) {
-                            QStringList l = val.split(':');
-                            QString run = QFileInfo(l.at(0).trimmed()).
-                                                            absoluteFilePath();
-                            QString var =  l.at(1);
-                            if ( run == runDir && p == var) {
-                                p = key;
-                                isFound = true;
-                                break;
-                            }
-                        }
-                    }
-                    if ( isFound ) {
-                        break;
-                    }
-                }
-            }
-            mParams << p;
+        foreach ( QString p, loaded.at(i).params ) {
             pfnameToModel.insert(qMakePair(p,fname),m);
         }
         QString run = fileToRun.value(fname);
         QStringList params = runToParams.value(run);
-        params.append(mParams);
+        params.append(loaded.at(i).params);
         params.removeDuplicates();
         params.sort();
         runToParams.insert(run,params);
-        ++i;
+        if ( loaded.at(i).isNewHeader ) {
+            TrickModel* trickModel = static_cast<TrickModel*>(m);
+            runToCache.value(run)->insert(fname,trickModel->header());
+        }
+    }
+
+    // Save trk headers read this time so the next open can skip them
+    foreach ( TrkHeaderCache* cache, runToCache.values() ) {
+        cache->save();
+        delete cache;
     }
 
     // End Progress Dialog
@@ -220,6 +266,80 @@ void Runs::_init()
     }
 }
 
+// Creates the data model for fname and maps its params through _varMap.
+// If cache has fname's trk header, the header is not re-read from file.
+// This is called from pool threads, so it only reads Runs members and
+// reports errors through loaded->err instead of throwing.
+void Runs::_loadFile(const QString &fname, const TrkHeaderCache *cache,
+                     LoadedFile *loaded) const
+{
+    DataModel* m = 0;
+    try {
+        TrickHeader header;
+        if ( cache && cache->header(fname,&header) ) {
+            m = new TrickModel(_timeNames,fname,header);
+        } else {
+            m = DataModel::createDataModel(_timeNames,fname);
+            if ( cache && QFileInfo(fname).suffix() == "trk" ) {
+                loaded->isNewHeader = true;
+            }
+        }
+    } catch (std::exception &e) {
+        loaded->err = QString(e.what());
+        return;
+    }
+    m->unmap();
+
+    // Hand model over to the gui thread (it was created in this one)
+    if ( QCoreApplication::instance() ) {
+        m->moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    int ncols = m->columnCount();
+    QStringList mParams;
+    for ( int col = 0; col < ncols; ++col ) {
+        QString p = m->param(col)->name();
+        foreach (QString key, _varMap.keys() ) {
+            if ( p == key ) {
+                break;
+            }
+            QString runDir = QFileInfo(fname).absolutePath();
+            QStringList vals = _varMap.value(key);
+            QStringList names;
+            foreach ( QString val, vals ) {
+                MapValue mapval(val);
+                names.append(mapval.name());
+            }
+            if ( names.contains(p) ) {
+                p = key;
+                break;
+            } else {
+                bool isFound = false;
+                foreach (QString val, vals) {
+                    if ( val.contains(':') ) {
+                        QStringList l = val.split(':');
+                        QString run = QFileInfo(l.at(0).trimmed()).
+                                                        absoluteFilePath();
+                        QString var =  l.at(1);
+                        if ( run == runDir && p == var) {
+                            p = key;
+                            isFound = true;
+                            break;
+                        }
+                    }
+                }
+                if ( isFound ) {
+                    break;
+                }
+            }
+        }
+        mParams << p;
+    }
+
+    loaded->model = m;
+    loaded->params = mParams;
+}
+
 CurveModel* Runs::curveModel(int row,
                         const QString &tName,
                         const QString &xName,
@@ -14,12 +14,20 @@
 #include <QStandardItemModel>
 #include <QProgressDialog>
 #include <QRegExp>
+#include <QVector>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QCoreApplication>
 #include <stdexcept>
 #include "datamodel.h"
 #include "curvemodel.h"
 #include "numsortitem.h"
 #include "mapvalue.h"
 
+class TrkHeaderCache;
+
 class Runs
 {
   public:
@@ -63,6 +71,20 @@ class Runs
     QHash<QString,int> _rundir2row;
 
     void _init();
+
+    // Result of loading one log file (see _loadFile)
+    struct LoadedFile
+    {
+        DataModel* model;
+        QStringList params;
+        QString err;
+        bool isNewHeader;      // trk header was read from file, not cache
+        LoadedFile() : model(0), isNewHeader(false) {}
+    };
+    void _loadFile(const QString& fname, const TrkHeaderCache* cache,
+                   LoadedFile* loaded) const;
+    friend class RunsFileLoader;
+
     DataModel* _paramModel(const QString& param, const QString &run) const;
     int _paramColumn(DataModel* model, const QString& param) const;
 
@@ -131,11 +131,12 @@ Session::Session(const QString &sessionFileName) :
             }
             if ( _presentation != "compare" &&
                  _presentation != "error" &&
-                 _presentation != "error+compare") {
+                 _presentation != "error+compare" &&
+                 _presentation != "statistics" ) {
                 fprintf(stderr,"koviz [error]: session file has presentation "
                                "set to \"%s\".  For now, koviz only "
-                               "supports \"compare\", \"error\" and "
-                               "\"error+compare\"\n",
+                               "supports \"compare\", \"error\", "
+                               "\"error+compare\" and \"statistics\"\n",
                                _presentation.toLatin1().constData());
                 exit(-1);
             }
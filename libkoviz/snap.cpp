@@ -578,6 +578,8 @@ bool Snap::_process_jobs(DataModel* model )
 {
     bool ret = true;
 
+    QList<Job*> jobs;
+    QList<int> cols;
     int nParams = model->columnCount();
     for ( int i = 1 ; i < nParams; ++i ) {
         CurveModel* curve = new CurveModel(model,0,i,i);
@@ -590,6 +592,16 @@ bool Snap::_process_jobs(DataModel* model )
         QString job_id = job->job_id();
         _id_to_job[job_id] = job;
         _jobs.append(job);
+        jobs.append(job);
+        cols.append(i);
+    }
+
+    // All of the model's job stats in one pass (jobs are sorted by
+    // avg runtime right after this, which would otherwise read the
+    // model a column at a time)
+    SnapJobStats stats(model,0,cols);
+    for ( int k = 0; k < jobs.size(); ++k ) {
+        jobs.at(k)->setStats(stats.stats(k));
     }
 
     return ret;
@@ -613,6 +625,13 @@ QList<Frame> Snap::_process_frames()
 
     qSort(frames.begin(), frames.end(), frameTimeGreaterThan);
 
+    // Top jobs of the spikes are reported and tabled several times over
+    // copies of these frames, so calc them once here
+    int max_cnt = qMin(10,frames.size());
+    for ( int i = 0; i < max_cnt; ++i ) {
+        frames[i].topjobs();
+    }
+
     return frames;
 }
 
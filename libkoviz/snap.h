@@ -19,6 +19,7 @@
 #include "thread.h"
 #include "simobject.h"
 #include "frame.h"
+#include "snapjobstats.h"
 #include "utils.h"
 #include "snaptable.h"
 #include "datamodel.h"
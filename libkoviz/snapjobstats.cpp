@@ -0,0 +1,73 @@
+#include "snapjobstats.h"
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+
+static const int _rowsPerChunk = 65536;
+static const int _colsPerTask = 64;
+
+// Adds rows [row0,row1) of a group of job columns to their stats
+class SnapJobStatsTask : public QRunnable
+{
+  public:
+    SnapJobStatsTask(const DataModel* model, const QList<int>& cols,
+                     JobRuntimeStats* stats,
+                     int row0, int row1, const double* times) :
+        _model(model), _cols(cols), _stats(stats),
+        _row0(row0), _row1(row1), _times(times) {}
+
+    void run()
+    {
+        int n = _row1-_row0;
+        QVector<double> rts(n);
+        for ( int k = 0; k < _cols.size(); ++k ) {
+            int col = _cols.at(k);
+            _model->fill(col,col,col,_row0,_row1,0,0,rts.data());
+            JobRuntimeStats& stats = _stats[k];
+            for ( int i = 0; i < n; ++i ) {
+                stats.add(_times[i],rts.at(i));
+            }
+        }
+    }
+
+  private:
+    const DataModel* _model;
+    QList<int> _cols;
+    JobRuntimeStats* _stats;
+    int _row0;
+    int _row1;
+    const double* _times;
+};
+
+SnapJobStats::SnapJobStats(DataModel *model, int timeCol,
+                           const QList<int> &cols) :
+    _stats(cols.size())
+{
+    if ( cols.isEmpty() ) {
+        return;
+    }
+
+    model->map();
+
+    int nrows = model->rowCount();
+    QVector<double> times(qMin(nrows,_rowsPerChunk));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(QThread::idealThreadCount(),1));
+    for ( int row0 = 0; row0 < nrows; row0 += _rowsPerChunk ) {
+        int row1 = qMin(row0+_rowsPerChunk,nrows);
+        model->fill(timeCol,timeCol,timeCol,row0,row1,times.data(),0,0);
+
+        // A column group stays with one task per chunk so that its
+        // samples are added in row order
+        for ( int k0 = 0; k0 < cols.size(); k0 += _colsPerTask ) {
+            int k1 = qMin(k0+_colsPerTask,cols.size());
+            pool.start(new SnapJobStatsTask(model,cols.mid(k0,k1-k0),
+                                            _stats.data()+k0,
+                                            row0,row1,times.constData()));
+        }
+        pool.waitForDone();
+    }
+
+    model->unmap();
+}
@@ -0,0 +1,27 @@
+#ifndef SNAPJOBSTATS_H
+#define SNAPJOBSTATS_H
+
+#include <QList>
+#include <QVector>
+#include "datamodel.h"
+#include "job.h"
+
+// Runtime stats of many jobs (columns) of one job timing model
+//
+// The model is read once, in row chunks, instead of once per job.  The
+// time column of a chunk is read by the caller and shared; pool tasks
+// each take a group of job columns and add the chunk to their jobs'
+// accumulators.  Memory is bounded by the chunk size, not the run length.
+class SnapJobStats
+{
+  public:
+    SnapJobStats(DataModel* model, int timeCol, const QList<int>& cols);
+
+    int count() const { return _stats.size(); }
+    const JobRuntimeStats& stats(int k) const { return _stats.at(k); }
+
+  private:
+    QVector<JobRuntimeStats> _stats;   // one per col, in order
+};
+
+#endif // SNAPJOBSTATS_H
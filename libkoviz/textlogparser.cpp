@@ -0,0 +1,455 @@
+#include "textlogparser.h"
+
+static const int _rowsPerTask = 16384;
+
+// Exact powers of ten (doubles represent these without rounding)
+static const double _pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//
+// Pool tasks
+//
+class TextLogRowCounter : public QRunnable
+{
+  public:
+    TextLogRowCounter(const char* beg, const char* end, qint64* count) :
+        _beg(beg), _end(end), _count(count) {}
+
+    void run()
+    {
+        qint64 n = 0;
+        const char* p = _beg;
+        while ( p < _end ) {
+            p = (const char*) memchr(p,'\n',_end-p);
+            if ( !p ) break;
+            ++n;
+            ++p;
+        }
+        *_count = n;
+    }
+
+  private:
+    const char* _beg;
+    const char* _end;
+    qint64* _count;
+};
+
+class TextLogRowFinder : public QRunnable
+{
+  public:
+    TextLogRowFinder(const TextLogParser* parser,
+                     const char* beg, const char* end,
+                     qint64* offsets) :
+        _parser(parser), _beg(beg), _end(end), _offsets(offsets) {}
+
+    void run()
+    {
+        int i = 0;
+        const char* p = _beg;
+        while ( p < _end ) {
+            p = (const char*) memchr(p,'\n',_end-p);
+            if ( !p ) break;
+            ++p;
+            _offsets[i++] = p-_parser->_data;
+        }
+    }
+
+  private:
+    const TextLogParser* _parser;
+    const char* _beg;
+    const char* _end;
+    qint64* _offsets;
+};
+
+class TextLogRowParser : public QRunnable
+{
+  public:
+    // out holds rows from outRow0 on
+    TextLogRowParser(const TextLogParser* parser, int row0, int row1,
+                     double* out, int ncols, QAtomicInt* nRowsDone,
+                     QAtomicInt* isCanceled, int* isDone, int outRow0=0) :
+        _parser(parser), _row0(row0), _row1(row1), _out(out), _ncols(ncols),
+        _nRowsDone(nRowsDone), _isCanceled(isCanceled), _isDone(isDone),
+        _outRow0(outRow0) {}
+
+    void run()
+    {
+        if ( _isCanceled->fetchAndAddOrdered(0) ) {
+            return;
+        }
+        const char* data = _parser->_data;
+        const qint64* offsets = _parser->_rowOffsets.constData();
+        char delim = _parser->_delimiter;
+        for ( int row = _row0; row < _row1; ++row ) {
+            const char* p = data+offsets[row];
+            const char* e = data+offsets[row+1];
+            while ( e > p && (e[-1] == '\n' || e[-1] == '\r') ) --e;
+            double* v = _out + (qint64)(row-_outRow0)*_ncols;
+            int col = 0;
+            while ( col < _ncols && p <= e ) {
+                const char* d = (const char*) memchr(p,delim,e-p);
+                if ( !d ) d = e;
+                v[col++] = _parser->_field(p,d);
+                p = d+1;
+            }
+            for ( ; col < _ncols; ++col ) {
+                v[col] = 0.0;
+            }
+        }
+        *_isDone = 1;
+        _nRowsDone->fetchAndAddOrdered(_row1-_row0);
+    }
+
+  private:
+    const TextLogParser* _parser;
+    int _row0;
+    int _row1;
+    double* _out;
+    int _ncols;
+    QAtomicInt* _nRowsDone;
+    QAtomicInt* _isCanceled;
+    int* _isDone;
+    int _outRow0;
+};
+
+class TextLogColumnParser : public QRunnable
+{
+  public:
+    TextLogColumnParser(const TextLogParser* parser, int row0, int row1,
+                        int col, double* out) :
+        _parser(parser), _row0(row0), _row1(row1), _col(col), _out(out) {}
+
+    void run()
+    {
+        const char* data = _parser->_data;
+        const qint64* offsets = _parser->_rowOffsets.constData();
+        char delim = _parser->_delimiter;
+        for ( int row = _row0; row < _row1; ++row ) {
+            const char* p = data+offsets[row];
+            const char* e = data+offsets[row+1];
+            while ( e > p && (e[-1] == '\n' || e[-1] == '\r') ) --e;
+            for ( int col = 0; col < _col && p <= e; ++col ) {
+                const char* d = (const char*) memchr(p,delim,e-p);
+                p = d ? d+1 : e+1;
+            }
+            if ( p <= e ) {
+                const char* d = (const char*) memchr(p,delim,e-p);
+                if ( !d ) d = e;
+                _out[row] = _parser->_field(p,d);
+            } else {
+                _out[row] = 0.0;
+            }
+        }
+    }
+
+  private:
+    const TextLogParser* _parser;
+    int _row0;
+    int _row1;
+    int _col;
+    double* _out;
+};
+
+//
+// TextLogParser
+//
+TextLogParser::TextLogParser(const char *data, qint64 beg, qint64 end,
+                             char delimiter, Converter convert) :
+    _data(data),
+    _beg(beg),
+    _end(end),
+    _delimiter(delimiter),
+    _convert(convert)
+{
+    _findRows();
+}
+
+// Rows are lines, a last line without a newline included
+void TextLogParser::_findRows()
+{
+    if ( _end <= _beg ) {
+        _rowOffsets = QVector<qint64>(1,_beg);
+        return;
+    }
+
+    // Count newlines in chunks (at least 1MB each) in parallel
+    int nThreads = QThread::idealThreadCount();
+    if ( nThreads < 1 ) nThreads = 1;
+    qint64 nbytes = _end-_beg;
+    qint64 chunkSize = qMax(nbytes/(4*nThreads)+1,(qint64)(1<<20));
+    int nChunks = (int)((nbytes+chunkSize-1)/chunkSize);
+    QVector<qint64> counts(nChunks);
+    QThreadPool pool;
+    pool.setMaxThreadCount(nThreads);
+    for ( int k = 0; k < nChunks; ++k ) {
+        const char* cbeg = _data+_beg+k*chunkSize;
+        const char* cend = _data+qMin(_beg+(k+1)*chunkSize,_end);
+        pool.start(new TextLogRowCounter(cbeg,cend,&counts[k]));
+    }
+    pool.waitForDone();
+
+    qint64 nNewlines = 0;
+    QVector<qint64> firstRow(nChunks);
+    for ( int k = 0; k < nChunks; ++k ) {
+        firstRow[k] = nNewlines;
+        nNewlines += counts.at(k);
+    }
+    qint64 nrows = nNewlines;
+    if ( _data[_end-1] != '\n' ) {
+        ++nrows;
+    }
+
+    // Row i+1 starts after newline i
+    _rowOffsets = QVector<qint64>(nrows+1+1);
+    _rowOffsets[0] = _beg;
+    qint64* offsets = _rowOffsets.data();
+    for ( int k = 0; k < nChunks; ++k ) {
+        const char* cbeg = _data+_beg+k*chunkSize;
+        const char* cend = _data+qMin(_beg+(k+1)*chunkSize,_end);
+        pool.start(new TextLogRowFinder(this,cbeg,cend,
+                                        offsets+1+firstRow.at(k)));
+    }
+    pool.waitForDone();
+    _rowOffsets.resize(nrows+1);
+    _rowOffsets[nrows] = _end;
+}
+
+int TextLogParser::parseRows(double *out, int ncols,
+                             QProgressDialog *progress) const
+{
+    int nrows = rowCount();
+    int nTasks = (nrows+_rowsPerTask-1)/_rowsPerTask;
+    QVector<int> isDone(nTasks,0);
+    QAtomicInt nRowsDone(0);
+    QAtomicInt isCanceled(0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(QThread::idealThreadCount(),1));
+    for ( int k = 0; k < nTasks; ++k ) {
+        int row0 = k*_rowsPerTask;
+        int row1 = qMin(row0+_rowsPerTask,nrows);
+        pool.start(new TextLogRowParser(this,row0,row1,out,ncols,
+                                        &nRowsDone,&isCanceled,
+                                        &isDone[k]));
+    }
+
+    if ( progress ) {
+        progress->setRange(0,nrows);
+        while ( !pool.waitForDone(100) ) {
+            progress->setValue(nRowsDone.fetchAndAddOrdered(0));
+            if ( progress->wasCanceled() ) {
+                isCanceled.fetchAndStoreOrdered(1);
+            }
+        }
+    }
+    pool.waitForDone();
+
+    // Rows up to the first task that did not run (if canceled)
+    int nParsed = 0;
+    for ( int k = 0; k < nTasks; ++k ) {
+        if ( !isDone.at(k) ) break;
+        nParsed = qMin((k+1)*_rowsPerTask,nrows);
+    }
+
+    return nParsed;
+}
+
+void TextLogParser::parseRows(int row0, int row1, double *out,
+                              int ncols) const
+{
+    QAtomicInt nRowsDone(0);
+    QAtomicInt isCanceled(0);
+    int isDone = 0;
+    TextLogRowParser task(this,row0,row1,out,ncols,
+                          &nRowsDone,&isCanceled,&isDone,row0);
+    task.run();
+}
+
+void TextLogParser::parseColumn(int col, double *out) const
+{
+    int nrows = rowCount();
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(QThread::idealThreadCount(),1));
+    for ( int row0 = 0; row0 < nrows; row0 += _rowsPerTask ) {
+        int row1 = qMin(row0+_rowsPerTask,nrows);
+        pool.start(new TextLogColumnParser(this,row0,row1,col,out));
+    }
+    pool.waitForDone();
+}
+
+double TextLogParser::_field(const char *beg, const char *end) const
+{
+    double val;
+    if ( !toDouble(beg,end,&val) ) {
+        val = _convert(QString::fromUtf8(beg,end-beg));
+    }
+    return val;
+}
+
+// Fast path for plain decimal numbers, e.g. -12.5e-3
+//
+// The value is exact (correctly rounded) when the digits fit in 2^53 and
+// the power of ten is within 1e22, so anything else is left to the
+// caller's (QString based) conversion by returning false.
+bool TextLogParser::toDouble(const char *s, const char *e, double *val)
+{
+    while ( s < e && (*s == ' ' || *s == '\t') ) ++s;
+    while ( e > s && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r') ) --e;
+    if ( s == e ) {
+        return false;
+    }
+
+    bool isNeg = false;
+    if ( *s == '-' ) {
+        isNeg = true;
+        ++s;
+    } else if ( *s == '+' ) {
+        ++s;
+    }
+
+    quint64 m = 0;
+    int nDigits = 0;
+    int exp10 = 0;
+    bool isDigit = false;
+    for ( ; s < e && (unsigned)(*s-'0') < 10; ++s ) {
+        isDigit = true;
+        if ( nDigits < 19 ) {
+            m = m*10 + (*s-'0');
+            if ( m ) ++nDigits;
+        } else {
+            ++exp10;
+        }
+    }
+    if ( s < e && *s == '.' ) {
+        ++s;
+        for ( ; s < e && (unsigned)(*s-'0') < 10; ++s ) {
+            isDigit = true;
+            if ( nDigits < 19 ) {
+                m = m*10 + (*s-'0');
+                if ( m ) ++nDigits;
+                --exp10;
+            }
+        }
+    }
+    if ( !isDigit ) {
+        return false;
+    }
+
+    if ( s < e && (*s == 'e' || *s == 'E') ) {
+        ++s;
+        bool isExpNeg = false;
+        if ( s < e && *s == '-' ) {
+            isExpNeg = true;
+            ++s;
+        } else if ( s < e && *s == '+' ) {
+            ++s;
+        }
+        int ev = 0;
+        bool isExpDigit = false;
+        for ( ; s < e && (unsigned)(*s-'0') < 10; ++s ) {
+            isExpDigit = true;
+            if ( ev < 10000 ) {
+                ev = ev*10 + (*s-'0');
+            }
+        }
+        if ( !isExpDigit ) {
+            return false;
+        }
+        exp10 += isExpNeg ? -ev : ev;
+    }
+
+    if ( s != e ) {
+        return false;
+    }
+
+    if ( m > ((quint64)1 << 53) || exp10 < -22 || exp10 > 22 ) {
+        if ( m != 0 ) {
+            return false;
+        }
+        exp10 = 0;
+    }
+
+    double v = (double)m;
+    if ( exp10 < 0 ) {
+        v /= _pow10[-exp10];
+    } else {
+        v *= _pow10[exp10];
+    }
+    *val = isNeg ? -v : v;
+
+    return true;
+}
+
+//
+// TextLogColumnCache
+//
+int TextLogColumnCache::lazyMinColumns = 256;
+int TextLogColumnCache::maxResidentColumns = 64;
+
+TextLogColumnCache::TextLogColumnCache(const TextLogParser *parser) :
+    _parser(parser)
+{
+}
+
+TextLogColumnCache::~TextLogColumnCache()
+{
+    foreach ( double* data, _col2data.values() ) {
+        delete[] data;
+    }
+}
+
+// Returns column data (parsed now if not resident) and holds it in memory
+// until unpinned
+const double* TextLogColumnCache::pin(int col)
+{
+    QMutexLocker locker(&_mutex);
+
+    double* data = _col2data.value(col,0);
+    if ( data ) {
+        _lru.removeOne(col);
+    } else {
+        data = new double[qMax(_parser->rowCount(),1)];
+        _parser->parseColumn(col,data);
+        _col2data.insert(col,data);
+    }
+    _lru.append(col);
+    _col2pins[col] += 1;
+
+    _evict();
+
+    return data;
+}
+
+void TextLogColumnCache::unpin(int col)
+{
+    QMutexLocker locker(&_mutex);
+    int pins = _col2pins.value(col,0);
+    if ( pins > 1 ) {
+        _col2pins.insert(col,pins-1);
+    } else {
+        _col2pins.remove(col);
+    }
+}
+
+double TextLogColumnCache::value(int row, int col)
+{
+    double v = pin(col)[row];
+    unpin(col);
+    return v;
+}
+
+void TextLogColumnCache::_evict()
+{
+    int i = 0;
+    while ( _col2data.size() > maxResidentColumns && i < _lru.size() ) {
+        int col = _lru.at(i);
+        if ( _col2pins.contains(col) ) {
+            ++i;
+            continue;
+        }
+        delete[] _col2data.take(col);
+        _lru.removeAt(i);
+    }
+}
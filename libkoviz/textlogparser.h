@@ -0,0 +1,98 @@
+#ifndef TEXTLOGPARSER_H
+#define TEXTLOGPARSER_H
+
+#include <QString>
+#include <QVector>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QProgressDialog>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <string.h>
+
+// Parses the data rows of a delimited text log (csv, mot) in place
+//
+// data is the memory mapped file and [beg,end) the bytes after the
+// header.  Rows are found with a parallel newline scan.  Fields are then
+// parsed on raw bytes by pool threads, straight into the caller's
+// buffers.  Fields the fast parser can't handle (e.g. hh:mm:ss, nan)
+// are handed to the model's converter as a QString.
+class TextLogParser
+{
+  public:
+    typedef double (*Converter)(const QString& field);
+
+    TextLogParser(const char* data, qint64 beg, qint64 end,
+                  char delimiter, Converter convert);
+
+    int rowCount() const { return _rowOffsets.size()-1; }
+    const QVector<qint64>& rowOffsets() const { return _rowOffsets; }
+
+    // Parses all rows into out (row-major, ncols per row).  Missing
+    // fields are zero and extra fields are ignored.  If progress is
+    // given, it is updated and may cancel the parse.  Returns the
+    // number of leading rows that were parsed.
+    int parseRows(double* out, int ncols, QProgressDialog* progress=0) const;
+
+    // Parses rows [row0,row1) into out on the calling thread
+    void parseRows(int row0, int row1, double* out, int ncols) const;
+
+    // Parses one column (for lazily loaded models)
+    void parseColumn(int col, double* out) const;
+
+    static bool toDouble(const char* beg, const char* end, double* val);
+
+  private:
+    TextLogParser() {}
+
+    const char* _data;
+    qint64 _beg;
+    qint64 _end;
+    char _delimiter;
+    Converter _convert;
+    QVector<qint64> _rowOffsets;  // row starts plus end of last row
+
+    void _findRows();
+    double _field(const char* beg, const char* end) const;
+
+    friend class TextLogRowCounter;
+    friend class TextLogRowFinder;
+    friend class TextLogRowParser;
+    friend class TextLogColumnParser;
+};
+
+// Lazily parsed columns of a text log
+//
+// Wide logs (see isLazy()) only have their rows found up front.  A
+// column is parsed the first time it is pinned.  Unpinned columns stay
+// resident until more than maxResidentColumns are loaded, then the
+// least recently used unpinned ones are freed.
+class TextLogColumnCache
+{
+  public:
+    TextLogColumnCache(const TextLogParser* parser);
+    ~TextLogColumnCache();
+
+    const double* pin(int col);
+    void unpin(int col);
+    double value(int row, int col);
+
+    static bool isLazy(int ncols) { return ncols >= lazyMinColumns; }
+    static int lazyMinColumns;
+    static int maxResidentColumns;
+
+  private:
+    const TextLogParser* _parser;
+    QMutex _mutex;
+    QHash<int,double*> _col2data;
+    QHash<int,int> _col2pins;
+    QList<int> _lru;              // least recently used first
+
+    void _evict();
+};
+
+#endif // TEXTLOGPARSER_H
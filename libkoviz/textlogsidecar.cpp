@@ -0,0 +1,263 @@
+#include "textlogsidecar.h"
+#include <utime.h>
+
+qint64 TextLogSidecar::maxCacheBytes = 4LL*1024LL*1024LL*1024LL;
+
+static const qint64 _blockDoubles = 1<<22;  // 32MB of parsed rows per block
+
+// Writes a wide log's column-major sidecar in the background
+class TextLogSidecarWriter : public QRunnable
+{
+  public:
+    TextLogSidecarWriter(TextLogSidecar* sidecar,
+                         const TextLogParser* parser, int ncols) :
+        _sidecar(sidecar), _parser(parser), _ncols(ncols) {}
+
+    void run()
+    {
+        _sidecar->_writeColumns(_parser,_ncols);
+    }
+
+  private:
+    TextLogSidecar* _sidecar;
+    const TextLogParser* _parser;
+    int _ncols;
+};
+
+TextLogSidecar::TextLogSidecar(const QString &logFile) :
+    _logFile(logFile),
+    _mem(0),
+    _isCanceled(0)
+{
+    QString absLogFile = QFileInfo(logFile).absoluteFilePath();
+    QByteArray hash = QCryptographicHash::hash(absLogFile.toUtf8(),
+                                               QCryptographicHash::Sha1);
+    _sidecarFile = kovizCacheDir() + "/" + QString(hash.toHex()) + ".dat";
+    _pool.setMaxThreadCount(1);
+}
+
+TextLogSidecar::~TextLogSidecar()
+{
+    _isCanceled.fetchAndStoreOrdered(1);
+    _pool.waitForDone();
+
+    if ( _mem ) {
+        _file.unmap(_mem);
+        _mem = 0;
+    }
+    _file.close();
+}
+
+// Returns the mapped data if there is an up-to-date, non-empty sidecar
+// with ncols columns in the given layout, else 0.  The data stays mapped
+// until the sidecar is deleted.
+const double* TextLogSidecar::map(int ncols, int *nrows, Layout layout)
+{
+    qint64 logSize;
+    qint64 logMtime;
+    if ( _mem || !_stat(_logFile,&logSize,&logMtime) ) {
+        return 0;
+    }
+
+    _file.setFileName(_sidecarFile);
+    if ( !_file.open(QIODevice::ReadOnly) ) {
+        return 0;
+    }
+
+    QDataStream in(&_file);
+    quint32 magic;
+    qint32 version;
+    qint32 byteOrder;
+    qint32 fileLayout;
+    qint64 size;
+    qint64 mtime;
+    qint64 nRows;
+    qint32 nCols;
+    in >> magic >> version >> byteOrder >> fileLayout
+       >> size >> mtime >> nRows >> nCols;
+    if ( in.status() != QDataStream::Ok ||
+         magic != _magic || version != _version ||
+         byteOrder != (qint32)QSysInfo::ByteOrder ||
+         fileLayout != (qint32)layout ||
+         size != logSize || mtime != logMtime ||
+         nCols != ncols || nCols <= 0 || nRows <= 0 || nRows > INT_MAX ||
+         _file.size() != _dataOffset + nRows*nCols*(qint64)sizeof(double) ) {
+        _file.close();
+        return 0;
+    }
+
+    _mem = _file.map(0,_file.size());
+    if ( !_mem ) {
+        _file.close();
+        return 0;
+    }
+
+    // Mark as recently used for pruning
+    utime(_sidecarFile.toLocal8Bit().constData(),0);
+
+    *nrows = (int)nRows;
+    return (const double*)(_mem+_dataOffset);
+}
+
+// Failing to write the sidecar is not an error, the log is parsed again
+// next time
+void TextLogSidecar::write(const double *data, int nrows, int ncols) const
+{
+    QFile file;
+    if ( !_openTmp(file,RowMajor,nrows,ncols) ) {
+        return;
+    }
+
+    // Raw doubles in native byte order
+    bool isOk = true;
+    qint64 nbytes = (qint64)nrows*ncols*sizeof(double);
+    const char* p = (const char*) data;
+    while ( nbytes > 0 ) {
+        qint64 n = file.write(p,qMin(nbytes,(qint64)(1<<26)));
+        if ( n <= 0 ) {
+            isOk = false;
+            break;
+        }
+        p += n;
+        nbytes -= n;
+    }
+
+    _commitTmp(file,isOk);
+}
+
+void TextLogSidecar::writeColumns(const TextLogParser *parser, int ncols)
+{
+    _pool.start(new TextLogSidecarWriter(this,parser,ncols));
+}
+
+bool TextLogSidecar::_writeColumns(const TextLogParser *parser, int ncols)
+{
+    int nrows = parser->rowCount();
+    QFile file;
+    if ( !_openTmp(file,ColumnMajor,nrows,ncols) ) {
+        return false;
+    }
+
+    // Parse a block of rows, then write each column's part of the block
+    // to where the column goes in the file
+    int blockRows = (int)qMax((qint64)1,_blockDoubles/ncols);
+    blockRows = qMin(blockRows,nrows);
+    QVector<double> rows((qint64)blockRows*ncols);
+    QVector<double> column(blockRows);
+    bool isOk = file.resize(_dataOffset+(qint64)nrows*ncols*sizeof(double));
+    for ( int row0 = 0; isOk && row0 < nrows; row0 += blockRows ) {
+        if ( _isCanceled.fetchAndAddOrdered(0) ) {
+            isOk = false;
+            break;
+        }
+        int n = qMin(blockRows,nrows-row0);
+        parser->parseRows(row0,row0+n,rows.data(),ncols);
+        for ( int col = 0; isOk && col < ncols; ++col ) {
+            const double* v = rows.constData()+col;
+            for ( int i = 0; i < n; ++i ) {
+                column[i] = v[(qint64)i*ncols];
+            }
+            qint64 pos = _dataOffset +
+                         ((qint64)col*nrows+row0)*sizeof(double);
+            qint64 nbytes = (qint64)n*sizeof(double);
+            isOk = file.seek(pos) &&
+                   file.write((const char*)column.constData(),nbytes)==nbytes;
+        }
+    }
+
+    _commitTmp(file,isOk);
+    return isOk;
+}
+
+// Opens the sidecar's tmp file and writes the header.  Returns false
+// if there is nothing to write, the log is gone or the data would not
+// fit in the cache.
+bool TextLogSidecar::_openTmp(QFile &file, Layout layout,
+                              int nrows, int ncols) const
+{
+    qint64 logSize;
+    qint64 logMtime;
+    if ( nrows <= 0 || ncols <= 0 || !_stat(_logFile,&logSize,&logMtime) ) {
+        return false;
+    }
+
+    qint64 nbytes = _dataOffset + (qint64)nrows*ncols*sizeof(double);
+    if ( nbytes > maxCacheBytes ) {
+        return false;
+    }
+    QFile::remove(_sidecarFile);  // replaced (and so not counted) below
+    _prune(nbytes);
+
+    file.setFileName(_sidecarFile + ".tmp");
+    if ( !file.open(QIODevice::WriteOnly) ) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << _magic << _version << (qint32)QSysInfo::ByteOrder << (qint32)layout
+        << logSize << logMtime << (qint64)nrows << (qint32)ncols;
+    if ( out.status() != QDataStream::Ok || !file.seek(_dataOffset) ) {
+        file.close();
+        QFile::remove(file.fileName());
+        return false;
+    }
+
+    return true;
+}
+
+// Renames the tmp file to the sidecar if it was written, else removes it
+void TextLogSidecar::_commitTmp(QFile &file, bool isOk) const
+{
+    QString tmpFile = file.fileName();
+    file.close();
+
+    if ( !isOk ) {
+        QFile::remove(tmpFile);
+        return;
+    }
+    QFile::remove(_sidecarFile);
+    QFile::rename(tmpFile,_sidecarFile);
+}
+
+// Removes least recently used sidecars until nbytes more fit under
+// maxCacheBytes.  Leftover tmp files (from a killed koviz) go too.
+void TextLogSidecar::_prune(qint64 nbytes)
+{
+    QDir dir(kovizCacheDir());
+
+    QDateTime staleTime = QDateTime::currentDateTime().addDays(-1);
+    foreach ( QFileInfo fi, dir.entryInfoList(QStringList("*.dat.tmp"),
+                                              QDir::Files) ) {
+        if ( fi.lastModified() < staleTime ) {
+            QFile::remove(fi.absoluteFilePath());
+        }
+    }
+
+    // Oldest first
+    QFileInfoList sidecars = dir.entryInfoList(QStringList("*.dat"),
+                                               QDir::Files,
+                                               QDir::Time|QDir::Reversed);
+    qint64 total = nbytes;
+    foreach ( QFileInfo fi, sidecars ) {
+        total += fi.size();
+    }
+    foreach ( QFileInfo fi, sidecars ) {
+        if ( total <= maxCacheBytes ) {
+            break;
+        }
+        if ( QFile::remove(fi.absoluteFilePath()) ) {
+            total -= fi.size();
+        }
+    }
+}
+
+bool TextLogSidecar::_stat(const QString &logFile, qint64 *size, qint64 *mtime)
+{
+    QFileInfo fi(logFile);
+    if ( !fi.exists() ) {
+        return false;
+    }
+    *size = fi.size();
+    *mtime = fi.lastModified().toMSecsSinceEpoch();
+    return true;
+}
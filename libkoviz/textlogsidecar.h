@@ -0,0 +1,69 @@
+#ifndef TEXTLOGSIDECAR_H
+#define TEXTLOGSIDECAR_H
+
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSysInfo>
+#include <QCryptographicHash>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <limits.h>
+#include "utils.h"
+#include "textlogparser.h"
+
+// Binary copy of a parsed text log (csv, mot) in kovizCacheDir()
+//
+// The sidecar holds the log's values as doubles after a fixed size
+// header, either row-major like a trk file's records (and like
+// CsvModel/MotModel's _data) or, for wide logs that are loaded a column
+// at a time, column-major.  It is keyed on the log's path and only used
+// while the log's size and mtime still match, so later opens of an
+// unchanged log map the sidecar instead of parsing text.
+//
+// Sidecars are pruned, least recently used first, when writing one
+// would put the cache over maxCacheBytes.
+class TextLogSidecar
+{
+  public:
+    enum Layout { RowMajor, ColumnMajor };
+
+    TextLogSidecar(const QString& logFile);
+    ~TextLogSidecar();
+
+    const double* map(int ncols, int* nrows, Layout layout=RowMajor);
+    void write(const double* data, int nrows, int ncols) const;
+
+    // Parses parser's rows a block at a time on a background thread and
+    // writes them column-major.  The write is canceled (and waited for)
+    // when this sidecar is deleted, so parser must outlive it.
+    void writeColumns(const TextLogParser* parser, int ncols);
+
+    static qint64 maxCacheBytes;
+
+  private:
+    QString _logFile;
+    QString _sidecarFile;
+    QFile _file;
+    uchar* _mem;
+    QThreadPool _pool;
+    QAtomicInt _isCanceled;
+
+    bool _writeColumns(const TextLogParser* parser, int ncols);
+    bool _openTmp(QFile& file, Layout layout, int nrows, int ncols) const;
+    void _commitTmp(QFile& file, bool isOk) const;
+
+    static bool _stat(const QString& logFile, qint64* size, qint64* mtime);
+    static void _prune(qint64 nbytes);
+
+    static const quint32 _magic = 0x4b54534c;  // "KTSL"
+    static const qint32 _version = 2;
+    static const qint64 _dataOffset = 64;
+
+    friend class TextLogSidecarWriter;
+};
+
+#endif // TEXTLOGSIDECAR_H
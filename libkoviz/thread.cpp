@@ -1,6 +1,7 @@
 #include "thread.h"
 
 #include <cmath>
+#include <QVector>
 #include <QtCore/qmath.h>
 
 QString Thread::_err_string;
@@ -156,6 +157,33 @@ void Thread::_do_stats()
         //
         Job* job0 = _jobs.at(0);
         CurveModel* curve = job0->curve();
+
+        // Sum job runtimes per row a column at a time, rather than
+        // iterating every job at every row
+        int nrows = curve->rowCount();
+        QVector<double> rowJobTimes(nrows,0.0);
+        QVector<double> rts(nrows);
+        foreach ( Job* job, _jobs ) {
+
+            if ( job->isFrameTimerJob() ) {
+                // For Trick 13
+                // Do not use child frame scheduling time for frame
+                // time sum.  Koviz reports the sum of the userjobs,
+                // not the frame scheduling time since the frame
+                // scheduling time includes executive overhead
+                // (e.g. the frame logging itself).
+                continue;
+            }
+
+            int n = qMin(nrows,job->curve()->rowCount());
+            job->curve()->fill(0,n,0,0,rts.data());
+            for ( int i = 0; i < n; ++i ) {
+                if ( rts.at(i) > 0 ) {
+                    rowJobTimes[i] += rts.at(i);
+                }
+            }
+        }
+
         ModelIterator* it = curve->begin();
         double frame_time = 0.0;
         _max_runtime = 0.0;
@@ -173,27 +201,7 @@ void Thread::_do_stats()
             while ( !it->isDone() && it->t()+epsilon < tnext ) {
 
                 jobTimeStampsAcrossFrame.append(it->t());
-
-                foreach ( Job* job, _jobs ) {
-
-                    if ( job->isFrameTimerJob() ) {
-                        // For Trick 13
-                        // Do not use child frame scheduling time for frame
-                        // time sum.  Koviz reports the sum of the userjobs,
-                        // not the frame scheduling time since the frame
-                        // scheduling time includes executive overhead
-                        // (e.g. the frame logging itself).
-                        continue;
-                    }
-
-                    ModelIterator* it2 = job->curve()->begin();
-                    double ft = it2->at(tidx)->x();
-                    delete it2;
-                    if ( ft < 0 ) {
-                        ft = 0.0;
-                    }
-                    frame_time += ft;
-                }
+                frame_time += rowJobTimes.at(tidx);
                 ++tidx;
                 it->next();
 
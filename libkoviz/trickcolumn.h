@@ -0,0 +1,48 @@
+#ifndef TRICKCOLUMN_H
+#define TRICKCOLUMN_H
+
+#include <QtGlobal>
+#include <string.h>
+
+// Type-specialized extraction of one column out of row-major trk records
+//
+// extract() converts n values of a Trick 07/10 param type, spaced
+// stride bytes apart, to doubles and applies out[i] = v*scale + bias.
+// The type switch happens once per call instead of once per value.
+// Returns false if the param type is not numeric, or is a LONG (whose
+// size depends on the logging machine, see TrickModel::_paramType()).
+//
+// With isByteSwap, values are byte swapped as they are loaded (for trk
+// files written on a machine of the other endianness).
+class TrickColumn
+{
+  public:
+    static bool extract(const char* src, qint64 stride, qint64 n,
+                        bool isTrick10, int paramType,
+                        double* out,
+                        double scale=1.0, double bias=0.0,
+                        bool isByteSwap=false);
+
+  private:
+    TrickColumn() {}
+
+    enum Kind
+    {
+        KindUnknown,
+        KindDouble,
+        KindFloat,
+        KindChar,
+        KindUChar,
+        KindShort,
+        KindUShort,
+        KindInt,
+        KindUInt,
+        KindLongLong,
+        KindULongLong,
+        KindBool
+    };
+
+    static Kind _kind(bool isTrick10, int paramType);
+};
+
+#endif // TRICKCOLUMN_H
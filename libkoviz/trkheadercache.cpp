@@ -0,0 +1,145 @@
+#include "trkheadercache.h"
+
+TrkHeaderCache::TrkHeaderCache(const QString &runDir) :
+    _isDirty(false)
+{
+    QString absRunDir = QDir(runDir).absolutePath();
+    QByteArray hash = QCryptographicHash::hash(absRunDir.toUtf8(),
+                                               QCryptographicHash::Sha1);
+    _cacheFile = kovizCacheDir() + "/" + QString(hash.toHex()) + ".hdr";
+    _load();
+}
+
+// Returns true and sets header if trkFile has an up-to-date entry
+bool TrkHeaderCache::header(const QString &trkFile, TrickHeader *header) const
+{
+    QString name = QFileInfo(trkFile).fileName();
+    if ( !_entries.contains(name) ) {
+        return false;
+    }
+
+    qint64 size;
+    qint64 mtime;
+    if ( !_stat(trkFile,&size,&mtime) ) {
+        return false;
+    }
+
+    const Entry& entry = _entries[name];
+    if ( entry.size != size || entry.mtime != mtime ) {
+        return false;
+    }
+
+    *header = entry.header;
+    return true;
+}
+
+void TrkHeaderCache::insert(const QString &trkFile, const TrickHeader &header)
+{
+    Entry entry;
+    if ( !_stat(trkFile,&entry.size,&entry.mtime) ) {
+        return;
+    }
+    entry.header = header;
+    _entries.insert(QFileInfo(trkFile).fileName(),entry);
+    _isDirty = true;
+}
+
+// Failing to write the cache is not an error, it is only slower next time
+void TrkHeaderCache::save()
+{
+    if ( !_isDirty ) {
+        return;
+    }
+
+    QString tmpFile = _cacheFile + ".tmp";
+    QFile file(tmpFile);
+    if ( !file.open(QIODevice::WriteOnly) ) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out << _magic << _version << (qint32)_entries.size();
+    foreach ( QString name, _entries.keys() ) {
+        const Entry& entry = _entries[name];
+        const TrickHeader& h = entry.header;
+        out << name << entry.size << entry.mtime;
+        out << (qint32)h.version << (qint8)h.endian << h.posBegData;
+        out << (qint32)h.params.size();
+        foreach ( TrickParameter p, h.params ) {
+            out << p.name() << p.unit() << (qint32)p.type() << (qint32)p.size();
+        }
+    }
+    file.close();
+
+    if ( out.status() != QDataStream::Ok ) {
+        QFile::remove(tmpFile);
+        return;
+    }
+    QFile::remove(_cacheFile);
+    QFile::rename(tmpFile,_cacheFile);
+    _isDirty = false;
+}
+
+void TrkHeaderCache::_load()
+{
+    QFile file(_cacheFile);
+    if ( !file.open(QIODevice::ReadOnly) ) {
+        return;
+    }
+
+    QDataStream in(&file);
+    quint32 magic;
+    qint32 version;
+    qint32 nEntries;
+    in >> magic >> version >> nEntries;
+    if ( magic != _magic || version != _version ) {
+        return;
+    }
+
+    QHash<QString,Entry> entries;
+    for ( int i = 0; i < nEntries; ++i ) {
+        QString name;
+        Entry entry;
+        qint32 trickVersion;
+        qint8 endian;
+        qint32 nParams;
+        in >> name >> entry.size >> entry.mtime;
+        in >> trickVersion >> endian >> entry.header.posBegData;
+        in >> nParams;
+        if ( in.status() != QDataStream::Ok || nParams < 0 ) {
+            return;
+        }
+        entry.header.version = trickVersion;
+        entry.header.endian = (char)endian;
+        for ( int j = 0; j < nParams; ++j ) {
+            QString pName;
+            QString pUnit;
+            qint32 pType;
+            qint32 pSize;
+            in >> pName >> pUnit >> pType >> pSize;
+            TrickParameter p;
+            p.setName(pName);
+            p.setUnit(pUnit);
+            p.setType(pType);
+            p.setSize(pSize);
+            entry.header.params.append(p);
+        }
+        entries.insert(name,entry);
+    }
+
+    // Ignore a truncated or otherwise corrupt cache
+    if ( in.status() == QDataStream::Ok ) {
+        _entries = entries;
+    }
+}
+
+bool TrkHeaderCache::_stat(const QString &trkFile, qint64 *size, qint64 *mtime)
+{
+    QFileInfo fi(trkFile);
+    if ( !fi.exists() ) {
+        return false;
+    }
+    *size = fi.size();
+    *mtime = fi.lastModified().toMSecsSinceEpoch();
+    return true;
+}
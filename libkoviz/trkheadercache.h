@@ -0,0 +1,48 @@
+#ifndef TRKHEADERCACHE_H
+#define TRKHEADERCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include "datamodel_trick.h"
+#include "utils.h"
+
+// On-disk cache of trk headers for a run directory
+//
+// The cache lives in kovizCacheDir() with one file per run directory.
+// An entry is only used if its trk file's size and mtime still match,
+// so stale entries are simply re-read from the trk file and replaced.
+class TrkHeaderCache
+{
+  public:
+    TrkHeaderCache(const QString& runDir);
+
+    bool header(const QString& trkFile, TrickHeader* header) const;
+    void insert(const QString& trkFile, const TrickHeader& header);
+    void save();
+
+  private:
+    struct Entry
+    {
+        qint64 size;
+        qint64 mtime;
+        TrickHeader header;
+    };
+
+    QString _cacheFile;
+    QHash<QString,Entry> _entries;   // key is trk file name
+    bool _isDirty;
+
+    void _load();
+    static bool _stat(const QString& trkFile, qint64* size, qint64* mtime);
+
+    static const quint32 _magic = 0x4b48434b;  // "KHCK"
+    static const qint32 _version = 1;
+};
+
+#endif // TRKHEADERCACHE_H
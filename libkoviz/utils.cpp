@@ -1,4 +1,8 @@
 #include "utils.h"
+#include <QDir>
+#if QT_VERSION >= 0x050000
+#include <QStandardPaths>
+#endif
 
 static int _idxAtTimeBinarySearch (double* timestamps,
                                   int low, int high, double time);
@@ -25,6 +29,19 @@ int getIndexAtTime( int ntimestamps, double* timestamps, double time)
                                        0, ntimestamps-1, time );
 }
 
+QString kovizCacheDir()
+{
+#if QT_VERSION >= 0x050000
+    QString dir = QStandardPaths::writableLocation(
+                                    QStandardPaths::GenericCacheLocation);
+#else
+    QString dir = QDir::homePath() + "/.cache";
+#endif
+    dir += "/koviz";
+    QDir().mkpath(dir);
+    return dir;
+}
+
 int _idxAtTimeBinarySearch (double* timestamps,
                             int low, int high, double time)
 {
@@ -2,10 +2,14 @@
 #define UTILS_H
 
 #include <QVariant>
+#include <QString>
 
 long round_10(long a);
 int getIndexAtTime( int ntimestamps, double* timestamps, double time);
 
+// Directory for koviz's on-disk caches (created if it doesn't exist)
+QString kovizCacheDir();
+
 //
 // With QAbstractItemModels' data(), setData() etc. methods you use
 // QVariants.  These templates are hacks so you can pass ptrs from
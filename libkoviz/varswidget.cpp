@@ -1,9 +1,5 @@
 #include "varswidget.h"
 
-#ifdef __linux
-#include "timeit_linux.h"
-#endif
-
 VarsWidget::VarsWidget(const QString &timeName,
                        QStandardItemModel* varsModel,
                        const QStringList& runDirs,
@@ -20,7 +16,11 @@ VarsWidget::VarsWidget(const QString &timeName,
     _plotModel(plotModel),
     _plotSelectModel(plotSelectModel),
     _monteInputsView(monteInputsView),
-    _qpId(0)
+    _qpId(0),
+    _curvesLoader(new CurvesLoader(this)),
+    _progress(0),
+    _nCurvesQueued(0),
+    _nCurvesAdded(0)
 {
     // Setup models
     _varsFilterModel = new QSortFilterProxyModel;
@@ -50,10 +50,23 @@ VarsWidget::VarsWidget(const QString &timeName,
          SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
          this,
          SLOT(_varsSelectModelSelectionChanged(QItemSelection,QItemSelection)));
+
+    // Curve paths are built on pool threads
+    connect(_curvesLoader,SIGNAL(built(CurvePathBuild*)),
+            this,SLOT(_curveBuilt(CurvePathBuild*)));
 }
 
 VarsWidget::~VarsWidget()
 {
+    // Loader deletes the curves it still has, the rest are built
+    delete _curvesLoader;
+    foreach ( VarsPendingCurve pendingCurve, _pendingCurves ) {
+        if ( pendingCurve.build ) {
+            delete pendingCurve.curveModel;
+            delete pendingCurve.build;
+        }
+    }
+
     if ( _varsSelectModel ) {
         delete _varsSelectModel;
     }
@@ -127,21 +140,7 @@ void VarsWidget::_varsSelectModelSelectionChanged(
             }
             QStandardItem* pageItem = _plotModel->itemFromIndex(pageIdx);
             QModelIndexList currVarIdxs = currVarSelection.indexes();
-            int rc = currVarIdxs.size();
-            QProgressDialog progress("Loading curves...", "Abort", 0, rc, this);
-            progress.setWindowModality(Qt::WindowModal);
-            progress.setMinimumDuration(500);
-#ifdef __linux
-            TimeItLinux timer;
-            timer.start();
-#endif
-            int r = 0;
             while ( ! currVarIdxs.isEmpty() ) {
-                // Update progress dialog
-                progress.setValue(r++);
-                if (progress.wasCanceled()) {
-                    break;
-                }
                 QModelIndex varIdx = currVarIdxs.takeFirst();
                 int nPlots = _plotModel->plotIdxs(pageIdx).size();
                 if ( nPlots == 6 ) {
@@ -152,15 +151,7 @@ void VarsWidget::_varsSelectModelSelectionChanged(
                 _plotSelectModel->setCurrentIndex(pageIdx,
                                                   QItemSelectionModel::Current);
                 //_selectCurrentRunOnPageItem(pageItem);
-#ifdef __linux
-                int secs = qRound(timer.stop()/1000000.0);
-                div_t d = div(secs,60);
-                QString msg = QString("Loaded %1 of %2 curves (%3 min %4 sec)")
-                             .arg(r+1).arg(rc).arg(d.quot).arg(d.rem);
-                progress.setLabelText(msg);
-#endif
             }
-            progress.setValue(rc);
         }
     }
 }
@@ -208,6 +199,13 @@ void VarsWidget::selectAllVars()
     _listView->selectAll();
 }
 
+// Adds all queued curves to the book now, for when there is no event
+// loop to add them as they are built (e.g. koviz -a -pdf)
+void VarsWidget::waitForCurves()
+{
+    _curvesLoader->waitForDone();
+}
+
 QStandardItem* VarsWidget::_createPageItem()
 {
     QModelIndex pagesIdx = _plotModel->getIndex(QModelIndex(), "Pages");
@@ -279,25 +277,10 @@ void VarsWidget::_addPlotToPage(QStandardItem* pageItem,
     QModelIndex curvesIdx = _plotModel->indexFromItem(curvesItem);
     _addCurves(curvesIdx,yName);
 
-    // Reset monte carlo input view current idx to signal current changed
-    int currRunId = -1;
-    if ( _monteInputsView ) {
-        currRunId = _monteInputsView->currentRun();
-    }
-
-    if ( currRunId >= 0 ) {
-        foreach (QModelIndex curveIdx, _plotModel->curveIdxs(curvesIdx)) {
-            int curveRunId = _plotModel->getDataInt(curveIdx,
-                                                    "CurveRunID","Curve");
-            if ( curveRunId == currRunId ) {
-                // Reset monte input view's current index which will set
-                // plot view's current index (by way of signal/slot connections)
-                QModelIndex currIdx = _monteInputsView->currentIndex();
-                _monteInputsView->setCurrentIndex(QModelIndex());
-                _monteInputsView->setCurrentIndex(currIdx);
-                break;
-            }
-        }
+    // Monte carlo current run is reset once the plot's curves are loaded
+    VarsLoadingPlot* loadingPlot = _loadingPlot(curvesIdx);
+    if ( loadingPlot ) {
+        loadingPlot->isNewPlot = true;
     }
 }
 
@@ -334,9 +317,6 @@ void VarsWidget::_selectCurrentRunOnPageItem(QStandardItem* pageItem)
 
 void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
 {
-    // Turn off model signals when adding children for significant speedup
-    bool block = _plotModel->blockSignals(true);
-
     int rc = _runDirs.count();
     QList<QColor> colors = _plotModel->createCurveColors(rc);
 
@@ -347,16 +327,6 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
         run2color.insert(runId, colors.at(r).name());
     }
 
-    // Setup progress bar dialog for time intensive loads
-    QProgressDialog progress("Loading curves...", "Abort", 0, rc, this);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.setMinimumDuration(500);
-
-#ifdef __linux
-    TimeItLinux timer;
-    timer.start();
-#endif
-
     bool isGroups = false;
     QStringList groups;
     QModelIndex groupsIdx = _plotModel->getIndex(QModelIndex(),"Groups","");
@@ -370,19 +340,46 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
         }
     }
 
-    int nCurves = _plotModel->rowCount(curvesIdx);
-    int ii = nCurves; // When alt+click adding curves, this is needed
-    int jj = 0;
+    // Curves still loading count as being on the plot
+    QString yUnit0;
+    int nCurves0 = _plotModel->rowCount(curvesIdx);
+    if ( nCurves0 > 0 ) {
+        QModelIndex curveIdx0 = _plotModel->getIndex(curvesIdx,"Curve",
+                                                     "Curves");
+        yUnit0 = _plotModel->getDataString(curveIdx0,"CurveYUnit","Curve");
+    }
+    foreach ( VarsPendingCurve pendingCurve, _pendingCurves ) {
+        if ( pendingCurve.curvesIdx == curvesIdx ) {
+            if ( nCurves0 == 0 ) {
+                yUnit0 = pendingCurve.yUnit;
+            }
+            ++nCurves0;
+        }
+    }
+    int ii = nCurves0; // When alt+click adding curves, this is needed
+
+    // For building the curve paths
+    QModelIndex plotIdx = curvesIdx.parent();
+    QString plotXScale = _plotModel->getDataString(plotIdx,"PlotXScale","Plot");
+    QString plotYScale = _plotModel->getDataString(plotIdx,"PlotYScale","Plot");
+    QString plotPresentation = _plotModel->getDataString(plotIdx,
+                                                         "PlotPresentation",
+                                                         "Plot");
+    double start = _plotModel->getDataDouble(QModelIndex(),"StartTime");
+    double stop = _plotModel->getDataDouble(QModelIndex(),"StopTime");
+
+    if ( rc > 0 && !_loadingPlot(curvesIdx) ) {
+        VarsLoadingPlot loadingPlot;
+        loadingPlot.curvesIdx = curvesIdx;
+        loadingPlot.queuedRect = _plotModel->getPlotMathRect(plotIdx);
+        loadingPlot.loadRect = loadingPlot.queuedRect;
+        loadingPlot.isNewPlot = false;
+        _loadingPlots.append(loadingPlot);
+    }
+
     QString u0;
-    QString r0;
     for ( int r = 0; r < rc; ++r) {
 
-        // Update progress dialog
-        progress.setValue(r);
-        if (progress.wasCanceled()) {
-            break;
-        }
-
         //
         // Create curves
         //
@@ -401,30 +398,29 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
             exit(-1);
         }
 
-
-        QStandardItem* curvesItem = _plotModel->itemFromIndex(curvesIdx);
-
-        QStandardItem *curveItem = _addChild(curvesItem,"Curve");
-
-        _addChild(curveItem, "CurveRunID", r);
-        _addChild(curveItem, "CurveTimeName", _timeName);
-        _addChild(curveItem, "CurveTimeUnit", curveModel->t()->unit());
-        _addChild(curveItem, "CurveXName", _timeName);
-        _addChild(curveItem, "CurveXUnit", curveModel->t()->unit()); // yes,t
-        _addChild(curveItem, "CurveYName", yName);
-        _addChild(curveItem, "CurveXMinRange", -DBL_MAX);
-        _addChild(curveItem, "CurveXMaxRange",  DBL_MAX);
-        _addChild(curveItem, "CurveYMinRange", -DBL_MAX);
-        _addChild(curveItem, "CurveYMaxRange",  DBL_MAX);
-        _addChild(curveItem, "CurveSymbolSize", "");
+        // The Curve item is added once its path is built
+        VarsPendingCurve curveItem;
+        curveItem.curvesIdx = curvesIdx;
+        curveItem.curveModel = curveModel;
+        curveItem.build = 0;
+
+        curveItem.addChild("CurveRunID", r);
+        curveItem.addChild("CurveTimeName", _timeName);
+        curveItem.addChild("CurveTimeUnit", curveModel->t()->unit());
+        curveItem.addChild("CurveXName", _timeName);
+        curveItem.addChild("CurveXUnit", curveModel->t()->unit()); // yes,t
+        curveItem.addChild("CurveYName", yName);
+        curveItem.addChild("CurveXMinRange", -DBL_MAX);
+        curveItem.addChild("CurveXMaxRange",  DBL_MAX);
+        curveItem.addChild("CurveYMinRange", -DBL_MAX);
+        curveItem.addChild("CurveYMaxRange",  DBL_MAX);
+        curveItem.addChild("CurveSymbolSize", "");
 
         QString yunit;
         if ( r == 0 ) {
-            if ( _plotModel->rowCount(curvesIdx) > 1 ) {
+            if ( nCurves0 > 0 ) {
                 // Multiple vars on plot with single run
-                QModelIndex curveIdx0 = _plotModel->getIndex(curvesIdx,"Curve",
-                                                             "Curves");
-                u0 = _plotModel->getDataString(curveIdx0,"CurveYUnit","Curve");
+                u0 = yUnit0;
                 QString u1 = curveModel->y()->unit();
                 if ( Unit::canConvert(u0,u1) ) {
                     yunit = u0;
@@ -435,7 +431,6 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
                 u0 = curveModel->y()->unit();
                 yunit = u0;
             }
-            r0 = QFileInfo(curveModel->fileName()).dir().dirName();
         } else {
             yunit = curveModel->y()->unit();
             QString u1 = yunit;
@@ -453,25 +448,27 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
                 }
             }
         }
-        _addChild(curveItem, "CurveYUnit", yunit);
+        curveItem.addChild("CurveYUnit", yunit);
+        curveItem.yUnit = yunit;
 
-        _addChild(curveItem, "CurveXScale", curveModel->x()->scale());
+        curveItem.addChild("CurveXScale", curveModel->x()->scale());
         QHash<QString,QVariant> shifts = _plotModel->getDataHash(QModelIndex(),
                                                               "RunToShiftHash");
         QString curveRunDir = QFileInfo(curveModel->fileName()).absolutePath();
+        double xBias;
         if ( shifts.contains(curveRunDir) ) {
-            double shiftVal = shifts.value(curveRunDir).toDouble();
-            _addChild(curveItem, "CurveXBias", shiftVal);
+            xBias = shifts.value(curveRunDir).toDouble();
         } else {
             // x bias can be set in a mapfile
-            _addChild(curveItem, "CurveXBias", curveModel->x()->bias());
+            xBias = curveModel->x()->bias();
         }
-        _addChild(curveItem, "CurveYScale", curveModel->y()->scale());
-        _addChild(curveItem, "CurveYBias", curveModel->y()->bias());
+        curveItem.addChild("CurveXBias", xBias);
+        curveItem.addChild("CurveYScale", curveModel->y()->scale());
+        curveItem.addChild("CurveYBias", curveModel->y()->bias());
 
         // Color
         QString color;
-        nCurves = _plotModel->rowCount(curvesIdx);
+        int nCurves = nCurves0+r+1;
         if ( rc == 1 ) {
             // Color each variable differently
             QList<QColor> curveColors = _plotModel->createCurveColors(nCurves);
@@ -500,7 +497,6 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
         // Linestyle
         QString style;
         QStringList styles = _plotModel->lineStyles();
-        nCurves = _plotModel->rowCount(curvesIdx);
         if ( rc == 1 ) {
             style = styles.at(0);
         } else {
@@ -610,52 +606,172 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
             }
         }
 
-        _addChild(curveItem, "CurveYLabel", yLabel);
-        _addChild(curveItem, "CurveColor", color);
-        _addChild(curveItem, "CurveLineStyle",style);
-        _addChild(curveItem, "CurveSymbolStyle", symbolStyle);
+        curveItem.addChild("CurveYLabel", yLabel);
+        curveItem.addChild("CurveColor", color);
+        curveItem.addChild("CurveLineStyle",style);
+        curveItem.addChild("CurveSymbolStyle", symbolStyle);
+
+        // Build the path the book model would make from the children
+        CurvePathSpec spec = _plotModel->curvePathSpec(curveModel,true,
+                                              curveModel->t()->unit(),
+                                              curveModel->x()->scale(),xBias,
+                                              yunit,
+                                              curveModel->y()->scale(),
+                                              curveModel->y()->bias(),
+                                              start,stop,
+                                              plotXScale,plotYScale);
+        spec.isStatistics = ( plotPresentation == "statistics" );
+        _pendingCurves.append(curveItem);
+        _curvesLoader->load(new CurvePathBuild(curveModel,spec));
+        ++_nCurvesQueued;
+
+        ++ii;
+    }
+
+    _updateProgress();
+}
+
+VarsLoadingPlot* VarsWidget::_loadingPlot(const QModelIndex &curvesIdx)
+{
+    for ( int i = 0; i < _loadingPlots.size(); ++i ) {
+        if ( _loadingPlots.at(i).curvesIdx == curvesIdx ) {
+            return &_loadingPlots[i];
+        }
+    }
+    return 0;
+}
+
+void VarsWidget::_curveBuilt(CurvePathBuild *build)
+{
+    for ( int i = 0; i < _pendingCurves.size(); ++i ) {
+        if ( _pendingCurves.at(i).curveModel == build->curveModel() ) {
+            _pendingCurves[i].build = build;
+            _addBuiltCurves();
+            return;
+        }
+    }
+
+    // Not pending (should not happen since canceled builds never get here)
+    delete build->curveModel();
+    delete build;
+}
+
+// Adds built curves to the book.  A plot's curves go in the order queued,
+// so a built curve waits on the plot's earlier curves still building.
+void VarsWidget::_addBuiltCurves()
+{
+    QList<int> ready;
+    QList<QPersistentModelIndex> waiting;
+    for ( int i = 0; i < _pendingCurves.size(); ++i ) {
+        const VarsPendingCurve& pendingCurve = _pendingCurves.at(i);
+        if ( waiting.contains(pendingCurve.curvesIdx) ) {
+            continue;
+        }
+        if ( !pendingCurve.build ) {
+            waiting.append(pendingCurve.curvesIdx);
+            continue;
+        }
+        ready.append(i);
+    }
+    if ( ready.isEmpty() ) {
+        return;
+    }
+
+    // Turn off model signals when adding children for significant speedup
+    bool block = _plotModel->blockSignals(true);
+
+    for ( int k = 0; k < ready.size(); ++k ) {
+        const VarsPendingCurve& pendingCurve = _pendingCurves.at(ready.at(k));
+        ++_nCurvesAdded;
+        if ( !pendingCurve.curvesIdx.isValid() ) {
+            // Plot was deleted while its curves were loading
+            delete pendingCurve.curveModel;
+            delete pendingCurve.build;
+            continue;
+        }
+
+        _plotModel->setCurvePathBuild(pendingCurve.build);
+
+        QStandardItem* curvesItem = _plotModel->itemFromIndex(
+                                                      pendingCurve.curvesIdx);
+        QStandardItem *curveItem = _addChild(curvesItem,"Curve");
+        for ( int c = 0; c < pendingCurve.children.size(); ++c ) {
+            _addChild(curveItem,pendingCurve.children.at(c).first,
+                                pendingCurve.children.at(c).second);
+        }
+
+        // Turn signals on for the plot's last curve for pixmap update
+        bool isLast = true;
+        for ( int m = k+1; m < ready.size(); ++m ) {
+            if ( _pendingCurves.at(ready.at(m)).curvesIdx ==
+                 pendingCurve.curvesIdx ) {
+                isLast = false;
+                break;
+            }
+        }
 
         // Add actual curve model data
-        if ( r == rc-1) {
-            // Turn signals on for last curve for pixmap update
+        if ( isLast ) {
             _plotModel->blockSignals(false);
         }
-        QVariant v = PtrToQVariant<CurveModel>::convert(curveModel);
+        QVariant v = PtrToQVariant<CurveModel>::convert(
+                                                     pendingCurve.curveModel);
         _addChild(curveItem, "CurveData", v);
-        if ( r == rc-1) {
+        if ( isLast ) {
             _plotModel->blockSignals(true);
         }
+    }
 
-#ifdef __linux
-        int secs = qRound(timer.stop()/1000000.0);
-        div_t d = div(secs,60);
-        QString msg = QString("Loaded %1 of %2 curves (%3 min %4 sec)")
-                             .arg(r+1).arg(rc).arg(d.quot).arg(d.rem);
-        progress.setLabelText(msg);
-#endif
+    // Turn signals back on
+    _plotModel->blockSignals(block);
 
-        ++ii;
-        ++jj;
+    for ( int k = ready.size()-1; k >= 0; --k ) {
+        _pendingCurves.removeAt(ready.at(k));
     }
 
-    // Turn signals back on before adding curveModel
-    _plotModel->blockSignals(block);
+    // Fit plots to the curves so far and finish plots that are done
+    for ( int i = 0; i < _loadingPlots.size(); ) {
+        VarsLoadingPlot& plot = _loadingPlots[i];
+        if ( !plot.curvesIdx.isValid() ) {
+            _loadingPlots.removeAt(i);
+            continue;
+        }
+        _updatePlotMathRect(plot);
+        if ( !waiting.contains(plot.curvesIdx) ) {
+            VarsLoadingPlot donePlot = _loadingPlots.takeAt(i);
+            _finishPlot(donePlot);
+            continue;
+        }
+        ++i;
+    }
 
-    // Update progress dialog
-    progress.setValue(rc);
+    _updateProgress();
+}
 
-    // Initialize plot math rect
-    QRectF bbox = _plotModel->calcCurvesBBox(curvesIdx);
+// Initialize plot math rect to its curves unless it has been zoomed/panned
+// while loading
+void VarsWidget::_updatePlotMathRect(VarsLoadingPlot &plot)
+{
+    QModelIndex curvesIdx = plot.curvesIdx;
+    if ( _plotModel->rowCount(curvesIdx) == 0 ) {
+        return;
+    }
     QModelIndex plotIdx = curvesIdx.parent();
+    QRectF currRect = _plotModel->getPlotMathRect(plotIdx);
+    if ( currRect != plot.loadRect ) {
+        return;
+    }
+
+    QRectF bbox = _plotModel->calcCurvesBBox(curvesIdx);
     QModelIndex pageIdx = plotIdx.parent().parent();
-    QModelIndex plotMathRectIdx = _plotModel->getDataIndex(plotIdx,
-                                                           "PlotMathRect",
-                                                           "Plot");
     QModelIndexList siblingPlotIdxs = _plotModel->plotIdxs(pageIdx);
     foreach ( QModelIndex siblingPlotIdx, siblingPlotIdxs ) {
         bool isXTime = _plotModel->isXTime(siblingPlotIdx);
         if ( isXTime ) {
-            QRectF sibPlotRect = _plotModel->getPlotMathRect(siblingPlotIdx);
+            QRectF sibPlotRect = plot.queuedRect;
+            if ( siblingPlotIdx != plotIdx ) {
+                sibPlotRect = _plotModel->getPlotMathRect(siblingPlotIdx);
+            }
             if ( sibPlotRect.width() > 0 ) {
                 bbox.setLeft(sibPlotRect.left());
                 bbox.setRight(sibPlotRect.right());
@@ -663,5 +779,103 @@ void VarsWidget::_addCurves(QModelIndex curvesIdx, const QString &yName)
             break;
         }
     }
-    _plotModel->setData(plotMathRectIdx,bbox);
+
+    if ( bbox != currRect ) {
+        QModelIndex plotMathRectIdx = _plotModel->getDataIndex(plotIdx,
+                                                               "PlotMathRect",
+                                                               "Plot");
+        _plotModel->setData(plotMathRectIdx,bbox);
+        plot.loadRect = _plotModel->getPlotMathRect(plotIdx);
+    }
+}
+
+void VarsWidget::_finishPlot(const VarsLoadingPlot &plot)
+{
+    if ( !plot.isNewPlot ) {
+        return;
+    }
+
+    // Reset monte carlo input view current idx to signal current changed
+    int currRunId = -1;
+    if ( _monteInputsView ) {
+        currRunId = _monteInputsView->currentRun();
+    }
+
+    if ( currRunId >= 0 ) {
+        foreach (QModelIndex curveIdx, _plotModel->curveIdxs(plot.curvesIdx)) {
+            int curveRunId = _plotModel->getDataInt(curveIdx,
+                                                    "CurveRunID","Curve");
+            if ( curveRunId == currRunId ) {
+                // Reset monte input view's current index which will set
+                // plot view's current index (by way of signal/slot connections)
+                QModelIndex currIdx = _monteInputsView->currentIndex();
+                _monteInputsView->setCurrentIndex(QModelIndex());
+                _monteInputsView->setCurrentIndex(currIdx);
+                break;
+            }
+        }
+    }
+}
+
+// Abort button, curves already on plots stay
+void VarsWidget::_cancelCurves()
+{
+    // Builds still in the loader are deleted when they come back
+    _curvesLoader->cancel();
+    foreach ( VarsPendingCurve pendingCurve, _pendingCurves ) {
+        if ( pendingCurve.build ) {
+            delete pendingCurve.curveModel;
+            delete pendingCurve.build;
+        }
+    }
+    _pendingCurves.clear();
+
+    foreach ( VarsLoadingPlot plot, _loadingPlots ) {
+        if ( plot.curvesIdx.isValid() ) {
+            _updatePlotMathRect(plot);
+            _finishPlot(plot);
+        }
+    }
+    _loadingPlots.clear();
+
+    _updateProgress();
+}
+
+// Progress dialog (non-modal so plots can be looked at while loading)
+void VarsWidget::_updateProgress()
+{
+    if ( _pendingCurves.isEmpty() ) {
+        _nCurvesQueued = 0;
+        _nCurvesAdded = 0;
+        if ( _progress ) {
+            // May be in its canceled() signal, so delete later
+            _progress->hide();
+            _progress->deleteLater();
+            _progress = 0;
+        }
+        return;
+    }
+
+    if ( !_progress ) {
+        _progress = new QProgressDialog("Loading curves...","Abort",
+                                        0,_nCurvesQueued,this);
+        _progress->setAutoReset(false);
+        _progress->setAutoClose(false);
+        _progress->setMinimumDuration(500);
+        connect(_progress,SIGNAL(canceled()),this,SLOT(_cancelCurves()));
+#ifdef __linux
+        _timer.start();
+#endif
+    }
+    _progress->setMaximum(_nCurvesQueued);
+    _progress->setValue(_nCurvesAdded);
+
+#ifdef __linux
+    int secs = qRound(_timer.stop()/1000000.0);
+    div_t d = div(secs,60);
+    QString msg = QString("Loaded %1 of %2 curves (%3 min %4 sec)")
+                         .arg(_nCurvesAdded).arg(_nCurvesQueued)
+                         .arg(d.quot).arg(d.rem);
+    _progress->setLabelText(msg);
+#endif
 }
@@ -12,11 +12,45 @@
 #include <QDir>
 #include <QProgressDialog>
 #include <QApplication>
+#include <QPersistentModelIndex>
+#include <QRectF>
+#include <QPair>
 #include <float.h>
 #include <stdlib.h>
 #include "dp.h"
 #include "bookmodel.h"
 #include "monteinputsview.h"
+#include "curvesloader.h"
+#ifdef __linux
+#include "timeit_linux.h"
+#endif
+
+// A curve whose path is being built by the curves loader.  Its Curve item
+// (with the children below, in order) is added to the book once built.
+class VarsPendingCurve
+{
+  public:
+    QPersistentModelIndex curvesIdx;
+    CurveModel* curveModel;
+    QString yUnit;
+    QList<QPair<QString,QVariant> > children;
+    CurvePathBuild* build;    // 0 until built
+
+    void addChild(const QString& title, const QVariant& value=QVariant())
+    {
+        children.append(qMakePair(title,value));
+    }
+};
+
+// A plot with curves still loading
+class VarsLoadingPlot
+{
+  public:
+    QPersistentModelIndex curvesIdx;
+    QRectF queuedRect;    // plot math rect before its curves were queued
+    QRectF loadRect;      // last math rect set while loading
+    bool isNewPlot;
+};
 
 class VarsWidget : public QWidget
 {
@@ -34,6 +68,7 @@ public:
 
     void clearSelection();
     void selectAllVars();
+    void waitForCurves();
 
 
 signals:
@@ -57,6 +92,16 @@ private:
 
     int _qpId;
 
+    CurvesLoader* _curvesLoader;
+    QList<VarsPendingCurve> _pendingCurves;   // in the order queued
+    QList<VarsLoadingPlot> _loadingPlots;
+    QProgressDialog* _progress;
+    int _nCurvesQueued;
+    int _nCurvesAdded;
+#ifdef __linux
+    TimeItLinux _timer;
+#endif
+
     QModelIndex _findSinglePlotPageWithCurve(const QString& curveYName);
     QStandardItem* _createPageItem();
     void _addCurves(QModelIndex curvesIdx, const QString& yName);
@@ -66,6 +111,11 @@ private:
     void _addPlotToPage(QStandardItem* pageItem,
                                  const QModelIndex &varIdx);
     void _selectCurrentRunOnPageItem(QStandardItem* pageItem);
+    VarsLoadingPlot* _loadingPlot(const QModelIndex& curvesIdx);
+    void _addBuiltCurves();
+    void _updatePlotMathRect(VarsLoadingPlot& plot);
+    void _finishPlot(const VarsLoadingPlot& plot);
+    void _updateProgress();
 
 
 private slots:
@@ -73,6 +123,8 @@ private slots:
      void _varsSelectModelSelectionChanged(
                               const QItemSelection& currVarSelection,
                               const QItemSelection& prevVarSelection);
+     void _curveBuilt(CurvePathBuild* build);
+     void _cancelCurves();
 };
 
 #endif // VARSWIDGET_H